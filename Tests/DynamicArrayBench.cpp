@@ -0,0 +1,112 @@
+// Скорость push_back в DynamicArray: нынешняя сырая память (конструирование
+// на месте, перенос при росте) против прежней раскладки на new T[] (при росте
+// все новые элементы сначала конструируются по умолчанию, затем в них
+// присваиваются старые). Типы - FeedingEntry, std::string длиннее SSO и int.
+// Запуск: DynamicArrayBench [число элементов, по умолчанию 10000000]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include "DynamicArray.h"
+#include "FeedingTree.h"
+
+namespace {
+
+// Прежний DynamicArray: только то, что нужно для push_back
+template <typename T>
+class NewArrayStorage {
+public:
+    NewArrayStorage() : data(nullptr), count(0), capacity(0) {}
+    ~NewArrayStorage() { delete[] data; }
+    NewArrayStorage(const NewArrayStorage&) = delete;
+    NewArrayStorage& operator=(const NewArrayStorage&) = delete;
+
+    void push_back(const T& value) {
+        if (count >= capacity) {
+            reallocate(capacity == 0 ? 8 : capacity * 2);
+        }
+        data[count++] = value;
+    }
+
+    size_t size() const { return count; }
+    const T& operator[](size_t index) const { return data[index]; }
+
+private:
+    void reallocate(size_t newCapacity) {
+        T* newData = new T[newCapacity];
+        for (size_t i = 0; i < count; ++i) {
+            newData[i] = std::move(data[i]);
+        }
+        delete[] data;
+        data = newData;
+        capacity = newCapacity;
+    }
+
+    T* data;
+    size_t count;
+    size_t capacity;
+};
+
+template <typename Run>
+double milliseconds(Run run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Лучшее из нескольких прогонов: заполнение с нуля и освобождение
+template <typename Array, typename T>
+double fill(const DynamicArray<T>& values, int rounds, size_t& checksum) {
+    double best = 0;
+    for (int round = 0; round < rounds; ++round) {
+        double ms = milliseconds([&] {
+            Array array;
+            for (size_t i = 0; i < values.size(); ++i) {
+                array.push_back(values[i]);
+            }
+            checksum += array.size();
+        });
+        if (round == 0 || ms < best) best = ms;
+    }
+    return best;
+}
+
+template <typename T>
+void report(const char* name, const DynamicArray<T>& values, int rounds) {
+    size_t checksum = 0;
+    double oldMs = fill<NewArrayStorage<T>>(values, rounds, checksum);
+    double newMs = fill<DynamicArray<T>>(values, rounds, checksum);
+    if (checksum != 2 * rounds * values.size()) std::printf("size mismatch\n");
+    std::printf("%-14s new T[] %8.1f ms   DynamicArray %8.1f ms   (x%.2f)\n", name, oldMs, newMs, oldMs / newMs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long long parsed = argc > 1 ? std::atoll(argv[1]) : 10000000;
+    size_t count = parsed > 0 ? static_cast<size_t>(parsed) : 10000000;
+    const int rounds = 3;
+
+    DynamicArray<int> ints;
+    DynamicArray<std::string> strings;
+    DynamicArray<FeedingEntry> feedings;
+    ints.reserve(count);
+    strings.reserve(count);
+    feedings.reserve(count);
+    InternedString nickname("Симба");
+    InternedString feedType("Мясо");
+    char buffer[48];
+    for (size_t i = 0; i < count; ++i) {
+        ints.push_back(static_cast<int>(i));
+        std::snprintf(buffer, sizeof(buffer), "feeding-record-%012zu", i);
+        strings.push_back(buffer);
+        feedings.push_back(FeedingEntry{nickname, feedType, static_cast<int>(i % 20), static_cast<int32_t>(i)});
+    }
+
+    std::printf("%zu push_back calls, best of %d runs\n", count, rounds);
+    report("int", ints, rounds);
+    report("FeedingEntry", feedings, rounds);
+    report("std::string", strings, rounds);
+    return 0;
+}
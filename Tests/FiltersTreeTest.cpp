@@ -0,0 +1,119 @@
+// Проверка FiltersTree::searchInRange: номера диапазона идут в порядке ключей
+// (отчёт за период должен быть хронологическим) и совпадают с полным перебором.
+// Для ключей из пула строк порядок - по тексту, а не по id
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include "FiltersTree.h"
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char* what, int seed) {
+    if (!condition) {
+        std::cerr << "FAIL (seed " << seed << "): " << what << std::endl;
+        ++failures;
+    }
+}
+
+// Номер id лежит под ключом id / PER_KEY, поэтому порядок ключей
+// восстанавливается по самим номерам
+const int PER_KEY = 4;
+
+void checkRandomTree(int seed) {
+    std::mt19937 rng(seed);
+    const int keyCount = 1 + static_cast<int>(rng() % 300);
+    const int idCount = keyCount * PER_KEY;
+
+    DynamicArray<int> order;
+    for (int id = 0; id < idCount; ++id) {
+        order.push_back(id);
+    }
+    for (int i = idCount - 1; i > 0; --i) {
+        int j = static_cast<int>(rng() % (i + 1));
+        int tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    DateFiltersTree tree;
+    DynamicArray<bool> present;
+    for (int i = 0; i < idCount; ++i) {
+        present.push_back(false);
+    }
+    for (int i = 0; i < idCount; ++i) {
+        tree.add(order[i] / PER_KEY, order[i], 1);
+        present[order[i]] = true;
+    }
+    // Часть номеров удаляется, чтобы дерево прошло и через повороты удаления
+    for (int i = 0; i < idCount / 3; ++i) {
+        tree.remove(order[i] / PER_KEY, order[i], 1);
+        present[order[i]] = false;
+    }
+
+    for (int query = 0; query < 50; ++query) {
+        int from = static_cast<int>(rng() % (keyCount + 2)) - 1;
+        int to = from + static_cast<int>(rng() % (keyCount / 2 + 2));
+
+        PostingsView<PostingList> view = tree.searchInRange(from, to);
+        int previousKey = -1;
+        bool ordered = true;
+        bool inRange = true;
+        for (int id : view) {
+            int key = id / PER_KEY;
+            if (key < previousKey) ordered = false;
+            if (key < from || key > to) inRange = false;
+            previousKey = key;
+        }
+        check(ordered, "searchInRange returned keys out of order", seed);
+        check(inRange, "searchInRange returned a key outside the range", seed);
+
+        int expected = 0;
+        for (int id = 0; id < idCount; ++id) {
+            int key = id / PER_KEY;
+            if (present[id] && key >= from && key <= to) ++expected;
+        }
+        check(view.size() == expected, "searchInRange size differs from brute force", seed);
+        check(tree.countInRange(from, to) == expected, "countInRange differs from brute force", seed);
+    }
+}
+
+// Ключи интернируются в обратном алфавиту порядке, так что порядок id
+// противоположен порядку строк; границы диапазонов в пул не попадают
+void checkInternedOrder() {
+    const char* const species[] = { "zz-лев", "zz-еж", "zz-волк", "zz-барсук" };
+    SpeciesFiltersTree tree;
+    for (int i = 0; i < 4; ++i) {
+        tree.add(InternedString(species[i]), i);
+    }
+
+    PostingsView<PostingList> view = tree.searchInRange("zz-а", "zz-к");
+    int expected[] = { 3, 2, 1 };
+    int position = 0;
+    bool ordered = true;
+    for (int id : view) {
+        if (position >= 3 || id != expected[position]) ordered = false;
+        ++position;
+    }
+    check(ordered && position == 3, "interned range is not ordered by text", 0);
+    check(tree.countInRange("zz-в", "zz-я") == 3, "interned countInRange differs", 0);
+    check(tree.rank("zz-ж") == 3, "interned rank differs", 0);
+    check(tree.select(0) == 3, "interned select(0) is not the first string", 0);
+    check(!InternedString::lookup("zz-а").isValid(), "range probe was interned", 0);
+}
+
+} // namespace
+
+int main() {
+    for (int seed = 1; seed <= 200; ++seed) {
+        checkRandomTree(seed);
+    }
+    checkInternedOrder();
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "FiltersTree range tests passed" << std::endl;
+    return EXIT_SUCCESS;
+}
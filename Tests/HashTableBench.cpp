@@ -0,0 +1,148 @@
+// Задержка поиска в AnimalHashTable при заполнении 0.5-0.9: управляющие байты
+// плюс параллельные массивы против прежней раскладки "массив HashEntry"
+// (std::string, индекс и статус в одной записи, линейная проба k = 1).
+// Обе таблицы используют один и тот же HashUtils::hashBytes, поэтому разница -
+// только в раскладке памяти. Шаг у управляющих байтов - группа из 16 слотов,
+// у массива записей - один слот. Столбец "ctrl id hit" - поиск уже
+// интернированной клички (searchInterned): слоты сравниваются по id строки.
+// Запуск: HashTableBench [log2 ёмкости, по умолчанию 20]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include "AnimalHashTable.h"
+
+namespace {
+
+// Прежняя раскладка: каждый шаг пробы читает целую запись со строкой
+class EntryArrayTable {
+public:
+    explicit EntryArrayTable(int capacity) : capacity(capacity) {
+        entries = new Entry[capacity];
+    }
+    ~EntryArrayTable() { delete[] entries; }
+
+    void insert(const std::string& key, int index) {
+        int slot = static_cast<int>(HashUtils::hashBytes(key, HashUtils::DEFAULT_SEED) & (capacity - 1));
+        while (entries[slot].status == 1) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        entries[slot].key = key;
+        entries[slot].index = index;
+        entries[slot].status = 1;
+    }
+
+    int search(std::string_view key, int& steps) const {
+        int slot = static_cast<int>(HashUtils::hashBytes(key, HashUtils::DEFAULT_SEED) & (capacity - 1));
+        steps = 0;
+        for (int i = 0; i < capacity; ++i) {
+            steps++;
+            if (entries[slot].status == 0) return -1;
+            if (entries[slot].status == 1 && std::string_view(entries[slot].key) == key) return entries[slot].index;
+            slot = (slot + 1) & (capacity - 1);
+        }
+        return -1;
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        int index = -1;
+        int status = 0;
+    };
+    Entry* entries;
+    int capacity;
+};
+
+struct Result {
+    double nsPerLookup;
+    double stepsPerLookup;
+};
+
+// Поиск по InternedString через тот же measure
+struct InternedProbe {
+    const AnimalHashTable& table;
+    int search(InternedString key, int& steps) const { return table.searchInterned(key, steps); }
+};
+
+template <typename Table, typename Key>
+Result measure(const Table& table, const DynamicArray<Key>& queries) {
+    long long steps = 0;
+    long long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < queries.size(); ++i) {
+        int s;
+        checksum += table.search(queries[i], s);
+        steps += s;
+    }
+    auto finish = std::chrono::steady_clock::now();
+    // Контрольная сумма не даёт компилятору выбросить поиск
+    if (checksum == 42) std::printf(" ");
+    double ns = std::chrono::duration<double, std::nano>(finish - start).count();
+    return Result{ns / queries.size(), static_cast<double>(steps) / queries.size()};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int log2Capacity = argc > 1 ? std::atoi(argv[1]) : 20;
+    if (log2Capacity < 10 || log2Capacity > 26) log2Capacity = 20;
+    const int capacity = 1 << log2Capacity;
+    const int queryCount = 1 << 20;
+    const double loadFactors[] = { 0.5, 0.6, 0.7, 0.8, 0.9 };
+
+    // Ключи одинаковой длины, как клички в справочнике
+    DynamicArray<std::string> present;
+    DynamicArray<std::string> absent;
+    int maxKeys = static_cast<int>(capacity * 0.9);
+    char buffer[32];
+    for (int i = 0; i < maxKeys; ++i) {
+        std::snprintf(buffer, sizeof(buffer), "animal%08d", i);
+        present.push_back(buffer);
+        std::snprintf(buffer, sizeof(buffer), "missing%07d", i);
+        absent.push_back(buffer);
+    }
+
+    std::printf("capacity %d, %d lookups per run, ns/lookup (steps/lookup)\n", capacity, queryCount);
+    std::printf("%-6s %-22s %-22s %-22s %-22s %-22s\n", "load", "ctrl hit", "ctrl id hit", "ctrl miss",
+                "entries hit", "entries miss");
+
+    std::mt19937 rng(12345);
+    for (double loadFactor : loadFactors) {
+        int count = static_cast<int>(capacity * loadFactor);
+
+        AnimalHashTable table(capacity);
+        table.setMaxLoadFactor(0.95);
+        table.setIncrementalRehash(false);
+        EntryArrayTable entries(capacity);
+        for (int i = 0; i < count; ++i) {
+            table.insert(InternedString(present[i]), i);
+            entries.insert(present[i], i);
+        }
+
+        DynamicArray<std::string_view> hits;
+        DynamicArray<InternedString> internedHits;
+        DynamicArray<std::string_view> misses;
+        for (int i = 0; i < queryCount; ++i) {
+            hits.push_back(present[rng() % count]);
+            internedHits.push_back(InternedString::lookup(hits[i]));
+            misses.push_back(absent[rng() % maxKeys]);
+        }
+
+        Result ctrlHit = measure(table, hits);
+        Result ctrlIdHit = measure(InternedProbe{table}, internedHits);
+        Result ctrlMiss = measure(table, misses);
+        Result entryHit = measure(entries, hits);
+        Result entryMiss = measure(entries, misses);
+
+        char cells[5][32];
+        const Result* results[5] = { &ctrlHit, &ctrlIdHit, &ctrlMiss, &entryHit, &entryMiss };
+        for (int i = 0; i < 5; ++i) {
+            std::snprintf(cells[i], sizeof(cells[i]), "%6.1f (%.2f)", results[i]->nsPerLookup, results[i]->stepsPerLookup);
+        }
+        std::printf("%-6.2f %-22s %-22s %-22s %-22s %-22s\n", table.getLoadFactor(), cells[0], cells[1], cells[2],
+                    cells[3], cells[4]);
+    }
+    return 0;
+}
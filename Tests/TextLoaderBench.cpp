@@ -0,0 +1,176 @@
+// Скорость загрузки файла кормлений. Главное сравнение - полные загрузчики:
+// прежний FeedingTree::importFromFile (getline + istringstream, поля через
+// operator>> с интернированием) против нынешнего (отображение файла, поля -
+// string_view, from_chars); результаты обязаны совпасть. Для справки
+// отдельно замеряется один разбор без построения записей, и параллельный
+// импорт на 1-8 потоках.
+// Запуск: TextLoaderBench [размер файла в МБ, по умолчанию 1024] [путь к файлу]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include "DateUtils.h"
+#include "FeedingTree.h"
+#include "TextLoader.h"
+
+namespace {
+
+struct Counts {
+    long long rows = 0;
+    long long skipped = 0;
+    long long quantitySum = 0;
+};
+
+void generate(const std::string& path, size_t megabytes) {
+    static const char* const nicknames[] = { "Симба", "Нала", "Багира", "Балу", "Шерхан", "Акела", "Каа", "Раджа" };
+    static const char* const feedTypes[] = { "Мясо", "Рыба", "Овощи", "Фрукты", "Зерно" };
+    std::ofstream out(path, std::ios::binary);
+    std::mt19937 rng(2024);
+    size_t target = megabytes * 1024 * 1024;
+    size_t written = 0;
+    char line[128];
+    while (written < target) {
+        int day = 1 + static_cast<int>(rng() % 28);
+        int month = 1 + static_cast<int>(rng() % 12);
+        int year = 2015 + static_cast<int>(rng() % 10);
+        int length = std::snprintf(line, sizeof(line), "%s %s %d %02d.%02d.%04d\n",
+                                   nicknames[rng() % 8], feedTypes[rng() % 5],
+                                   1 + static_cast<int>(rng() % 20), day, month, year);
+        out.write(line, length);
+        written += static_cast<size_t>(length);
+    }
+}
+
+Counts parseWithStreams(const std::string& path) {
+    Counts counts;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::string nickname, feedType, date;
+        int quantity;
+        int32_t day;
+        if (!(iss >> nickname >> feedType >> quantity >> date) || !DateUtils::parseDate(date, day)) {
+            counts.skipped++;
+            continue;
+        }
+        counts.rows++;
+        counts.quantitySum += quantity;
+    }
+    return counts;
+}
+
+Counts parseWithTextLoader(const std::string& path) {
+    Counts counts;
+    TextLoader::forEachLine(path, [&](std::string_view line) {
+        std::string_view fields[4];
+        int quantity;
+        int32_t day;
+        if (TextLoader::splitFields(line, fields, 4) < 4 || !TextLoader::parseInt(fields[2], quantity) ||
+            !DateUtils::parseDate(fields[3], day)) {
+            counts.skipped++;
+            return true;
+        }
+        counts.rows++;
+        counts.quantitySum += quantity;
+        return true;
+    });
+    return counts;
+}
+
+// Прежний importFromFile: строка копируется в istringstream, поля читаются
+// operator>> (кличка и корм - сразу в пул строк)
+void importWithStreams(const std::string& path, DynamicArray<FeedingEntry>& out) {
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream iss(line);
+        FeedingEntry entry;
+        std::string date;
+        if (!(iss >> entry.nickname >> entry.feedType >> entry.quantity >> date) ||
+            !DateUtils::parseDate(date, entry.date)) {
+            continue;
+        }
+        out.push_back(entry);
+    }
+}
+
+bool sameEntries(const DynamicArray<FeedingEntry>& a, const DynamicArray<FeedingEntry>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].nickname != b[i].nickname || a[i].feedType != b[i].feedType ||
+            a[i].quantity != b[i].quantity || a[i].date != b[i].date) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Run>
+double seconds(Run run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 1024;
+    if (megabytes == 0) megabytes = 1024;
+    std::string path = argc > 2 ? argv[2] : "feedings_bench.txt";
+
+    generate(path, megabytes);
+    std::ifstream probe(path, std::ios::binary | std::ios::ate);
+    double fileMb = static_cast<double>(probe.tellg()) / (1024.0 * 1024.0);
+    std::printf("file %s, %.0f MB\n", path.c_str(), fileMb);
+
+    FeedingTree tree;
+    DynamicArray<FeedingEntry> streamEntries, single;
+    double streamImportTime = seconds([&] { importWithStreams(path, streamEntries); });
+    double importTime = seconds([&] { tree.importFromFile(path, single); });
+    if (!sameEntries(streamEntries, single)) {
+        std::printf("MISMATCH: importFromFile differs from the istringstream loader\n");
+        return EXIT_FAILURE;
+    }
+    streamEntries = DynamicArray<FeedingEntry>();
+    std::printf("full loaders (records built, strings interned):\n");
+    std::printf("  %-34s %8.1f MB/s\n", "getline + istringstream", fileMb / streamImportTime);
+    std::printf("  %-34s %8.1f MB/s  (x%.1f)\n", "FeedingTree::importFromFile", fileMb / importTime,
+                streamImportTime / importTime);
+
+    Counts streams, loader;
+    double streamTime = seconds([&] { streams = parseWithStreams(path); });
+    double loaderTime = seconds([&] { loader = parseWithTextLoader(path); });
+    if (streams.rows != loader.rows || streams.skipped != loader.skipped ||
+        streams.quantitySum != loader.quantitySum) {
+        std::printf("MISMATCH: streams %lld/%lld rows, loader %lld/%lld rows\n",
+                    streams.rows, streams.skipped, loader.rows, loader.skipped);
+        return EXIT_FAILURE;
+    }
+    std::printf("tokenizer only (fields checked, nothing stored):\n");
+    std::printf("  %-34s %8.1f MB/s\n", "getline + istringstream", fileMb / streamTime);
+    std::printf("  %-34s %8.1f MB/s  (x%.1f)\n", "TextLoader", fileMb / loaderTime, streamTime / loaderTime);
+
+    // Масштабирование по потокам; 1 поток - тот же importFromFile
+    std::printf("parallel import:\n");
+    const int threadCounts[] = { 1, 2, 4, 8 };
+    for (int threads : threadCounts) {
+        DynamicArray<FeedingEntry> parallel;
+        double parallelTime = seconds([&] { tree.importFromFileParallel(path, parallel, nullptr, nullptr, threads); });
+        if (!sameEntries(parallel, single)) {
+            std::printf("MISMATCH: parallel import with %d threads differs from importFromFile\n", threads);
+            return EXIT_FAILURE;
+        }
+        char label[64];
+        std::snprintf(label, sizeof(label), "importFromFileParallel, %d thread%s", threads, threads > 1 ? "s" : "");
+        std::printf("  %-34s %8.1f MB/s  (x%.2f)\n", label, fileMb / parallelTime, importTime / parallelTime);
+    }
+    std::printf("hardware threads: %d\n", TextLoader::workerCount(0));
+
+    std::remove(path.c_str());
+    return 0;
+}
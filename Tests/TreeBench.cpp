@@ -0,0 +1,97 @@
+// Пропускная способность вставки и удаления в AVL-деревьях индексов:
+// FiltersTree<std::string>, FiltersTree<int> и FeedingTree. Ключи случайные
+// и различные, удаление идёт в другом случайном порядке. Используется только
+// открытый add/remove, поэтому тот же файл собирается и с прежней рекурсивной
+// реализацией для сравнения.
+// Запуск: TreeBench [число ключей, по умолчанию 1000000]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include "FeedingTree.h"
+#include "FiltersTree.h"
+
+namespace {
+
+template <typename Run>
+double milliseconds(Run run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void shuffle(DynamicArray<int>& values, std::mt19937& rng) {
+    for (size_t i = values.size(); i > 1; --i) {
+        size_t j = rng() % i;
+        int tmp = values[i - 1];
+        values[i - 1] = values[j];
+        values[j] = tmp;
+    }
+}
+
+void report(const char* name, double insertMs, double removeMs) {
+    std::printf("%-28s insert %8.1f ms   remove %8.1f ms\n", name, insertMs, removeMs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    if (count <= 0) count = 1000000;
+
+    std::mt19937 rng(7);
+    DynamicArray<int> insertOrder, removeOrder;
+    for (int i = 0; i < count; ++i) {
+        insertOrder.push_back(i);
+        removeOrder.push_back(i);
+    }
+    shuffle(insertOrder, rng);
+    shuffle(removeOrder, rng);
+
+    // Ключ i - случайное число, общее для всех деревьев
+    DynamicArray<int> intKeys;
+    DynamicArray<std::string> stringKeys;
+    DynamicArray<InternedString> internedKeys;
+    char buffer[32];
+    for (int i = 0; i < count; ++i) {
+        int key = static_cast<int>(rng() & 0x7FFFFFFF);
+        intKeys.push_back(key);
+        std::snprintf(buffer, sizeof(buffer), "key%010d-%d", key, i);
+        stringKeys.push_back(buffer);
+        internedKeys.push_back(InternedString(stringKeys[i]));
+    }
+    std::printf("%d keys\n", count);
+
+    {
+        FiltersTree<std::string> tree;
+        double insertMs = milliseconds([&] {
+            for (int i = 0; i < count; ++i) tree.add(stringKeys[insertOrder[i]], insertOrder[i]);
+        });
+        double removeMs = milliseconds([&] {
+            for (int i = 0; i < count; ++i) tree.remove(stringKeys[removeOrder[i]], removeOrder[i]);
+        });
+        report("FiltersTree<std::string>", insertMs, removeMs);
+    }
+    {
+        FiltersTree<int> tree;
+        double insertMs = milliseconds([&] {
+            for (int i = 0; i < count; ++i) tree.add(intKeys[insertOrder[i]], insertOrder[i]);
+        });
+        double removeMs = milliseconds([&] {
+            for (int i = 0; i < count; ++i) tree.remove(intKeys[removeOrder[i]], removeOrder[i]);
+        });
+        report("FiltersTree<int>", insertMs, removeMs);
+    }
+    {
+        FeedingTree tree;
+        double insertMs = milliseconds([&] {
+            for (int i = 0; i < count; ++i) tree.add(internedKeys[insertOrder[i]], insertOrder[i]);
+        });
+        double removeMs = milliseconds([&] {
+            for (int i = 0; i < count; ++i) tree.remove(internedKeys[removeOrder[i]], removeOrder[i]);
+        });
+        report("FeedingTree", insertMs, removeMs);
+    }
+    return 0;
+}
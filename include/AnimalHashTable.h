@@ -2,51 +2,85 @@
 #define ANIMAL_HASH_TABLE_H
 
 #include "DynamicArray.h"
+#include "SlotMap.h"
+#include "HashUtils.h"
+#include "StringPool.h"
 #include <string>
+#include <string_view>
 #include <ostream>
+#include <cstdint>
 
 struct Animal {
-    std::string nickname;
-    std::string species;
-    std::string cage;
+    InternedString nickname;
+    InternedString species;
+    InternedString cage;
 
     Animal() = default;
-    Animal(std::string nick, std::string sp, std::string c)
-        : nickname(std::move(nick)), species(std::move(sp)), cage(std::move(c)) {}
+    Animal(InternedString nick, InternedString sp, InternedString c)
+        : nickname(nick), species(sp), cage(c) {}
 };
 
 struct HashEntry {
-    std::string key;
+    InternedString key;
     int index;
     int status;
+    uint64_t hash;
 
-    HashEntry() : index(-1), status(0) {}
-    HashEntry(std::string k, int idx) : key(std::move(k)), index(idx), status(1) {}
+    HashEntry() : index(-1), status(0), hash(0) {}
+    HashEntry(InternedString k, int idx, uint64_t h) : key(k), index(idx), status(1), hash(h) {}
 };
 
 class AnimalHashTable {
 public:
-    AnimalHashTable(int initialSize = 16);
+    static constexpr uint64_t DEFAULT_SEED = HashUtils::DEFAULT_SEED;
+
+    AnimalHashTable(int initialSize = 16, uint64_t seed = DEFAULT_SEED);
     ~AnimalHashTable();
 
-    bool insert(const std::string& nickname, int index);
-    bool remove(const std::string& nickname);
-    int search(const std::string& nickname, int& steps) const;
+    bool insert(InternedString nickname, int index);
+    bool remove(std::string_view nickname);
+    // Во время миграции поиск тоже переносит до MIGRATION_STEP слотов, чтобы
+    // таблица, которую после роста только читают, не проверяла две таблицы
+    // вечно. Поэтому одновременные поиски из нескольких потоков - только
+    // через searchConcurrent, который таблицу не трогает
+    int search(std::string_view nickname, int& steps) const;
+    int searchConcurrent(std::string_view nickname, int& steps) const;
+    // Для уже интернированной клички: слоты сравниваются по id строки,
+    // текст клички при пробе не читается
+    int searchInterned(InternedString nickname, int& steps) const;
+    bool removeInterned(InternedString nickname);
+    // Пакетный поиск: хеши всех ключей считаются заранее и их слоты подгружаются
+    // в кэш до разрешения, чтобы промахи кэша перекрывались
+    void searchBatch(const std::string_view* nicknames, size_t count,
+                     int* outIndices, int* outSteps = nullptr) const;
     void clear();
     void resize(int newInitialSize);
+    // Заполнение с нуля за один проход: таблица сразу получает итоговую ёмкость
+    void build(const DynamicArray<Animal>& animals);
+    // То же для хранилища со стабильными id: в таблицу попадают id, а не позиции
+    void build(const SlotMap<Animal>& animals);
 
     int getSize() const { return size; }
-    int getCapacity() const { return capacity; }
-    double getLoadFactor() const { return static_cast<double>(size) / capacity; }
-
-    HashEntry getSlotInfo(int slotIndex) const {
-        if (slotIndex >= 0 && slotIndex < capacity) {
-            return table[slotIndex];
-        }
-        return HashEntry();
-    }
-
-    int getPrimaryHash(const std::string& key) const { return primaryHash(key); }
+    int getCapacity() const { return table.capacity; }
+    double getLoadFactor() const { return static_cast<double>(size) / table.capacity; }
+    // Порог роста таблицы: по умолчанию 0.75, допускается до 0.95 (Robin Hood
+    // держит короткие пробы и при плотном заполнении). Нужен бенчмарку
+    // Tests/HashTableBench.cpp для замеров на заполнении 0.5-0.9
+    void setMaxLoadFactor(double loadFactor);
+    double getMaxLoadFactor() const { return maxLoadFactor; }
+
+    // Постепенное перехеширование: старая и новая таблицы живут одновременно,
+    // каждая вставка/удаление переносит не больше MIGRATION_STEP слотов старой
+    void setIncrementalRehash(bool enabled);
+    bool isIncrementalRehash() const { return incrementalRehash; }
+    bool isMigrating() const { return oldTable.ctrl != nullptr; }
+    double getMigrationProgress() const;
+
+    HashEntry getSlotInfo(int slotIndex) const;
+    // Насколько запись ушла от своего первичного слота; -1 для пустого слота
+    int getProbeDistance(int slotIndex) const;
+
+    int getPrimaryHash(std::string_view key) const { return slotFor(table, hashKey(key, seed)); }
     int getSecondaryHash() const { return getStepSize(); }
 
     void print(std::ostream& out) const;
@@ -54,19 +88,86 @@ public:
     bool importFromFile(const std::string& filename, DynamicArray<Animal>& animals, int maxLines = 0);
     bool exportToFile(const std::string& filename, const DynamicArray<Animal>& animals) const;
 
+    // Массивы слотов для бинарного снимка (см. Snapshot.h). Перед записью
+    // незавершённая миграция доводится до конца. loadSlots сверяет слоты с уже
+    // прочитанными записями animals (ключи - ещё id строк файла) и ничего не
+    // меняет при ошибке; remapKeys затем переводит ключи в id текущего пула
+    void saveSlots(std::ostream& out);
+    bool loadSlots(const char*& cursor, const char* end, uint32_t stringCount,
+                   const SlotMap<Animal>& animals);
+    void remapKeys(const uint32_t* remap);
+
+    static uint64_t hashKey(std::string_view key, uint64_t seed) { return HashUtils::hashBytes(key, seed); }
+
+    // Ширина группы управляющих байтов, сканируемой за один шаг (SSE2)
+    static constexpr int GROUP_WIDTH = 16;
+
 private:
-    HashEntry* table;
-    int capacity;
+    // Раздельное хранение: управляющие байты (статус + 7 бит хеша) отдельно от ключей,
+    // чтобы проба читала одну кэш-линию вместо целых HashEntry
+    struct Slots {
+        uint8_t* ctrl;
+        uint32_t* keys;
+        int* indices;
+        uint64_t* hashes;
+        int capacity;
+    };
+
+    static constexpr uint8_t CTRL_EMPTY = 0x80;
+    // Только в старой таблице при миграции: запись перенесена, но проба идёт дальше
+    static constexpr uint8_t CTRL_MOVED = 0xFE;
+    static constexpr int MIGRATION_STEP = 64;
+    static constexpr int BATCH_WIDTH = 16;
+
+    // Изменяемы из константных search/searchBatch: перенос слотов не меняет
+    // видимого содержимого таблицы
+    mutable Slots table;
+    mutable Slots oldTable;
+    mutable int migrateCursor;
     int size;
     int initialCapacity;
+    uint64_t seed;
+    double maxLoadFactor;
+    bool incrementalRehash;
     static constexpr double LOAD_FACTOR_MAX = 0.75;
+    static constexpr double LOAD_FACTOR_LIMIT = 0.95;
     static constexpr double LOAD_FACTOR_MIN = 0.25;
 
-    int primaryHash(const std::string& key) const;
+    // Ёмкость всегда степень двойки: слот = hash & (capacity - 1)
+    static int roundUpPow2(int n);
+    static int slotFor(const Slots& slots, uint64_t hash) {
+        return static_cast<int>(hash & static_cast<uint64_t>(slots.capacity - 1));
+    }
+    static uint8_t fragmentOf(uint64_t hash) { return static_cast<uint8_t>(hash >> 57); }
+    static int probeDistance(const Slots& slots, int slot) {
+        return (slot - slotFor(slots, slots.hashes[slot])) & (slots.capacity - 1);
+    }
     int getStepSize() const;
 
+    static Slots allocateSlots(int slotCount);
+    static void releaseSlots(Slots& slots);
+    static void setCtrl(Slots& slots, int slot, uint8_t value);
+
+    // С семенем по умолчанию хеш берётся из пула, текст не читается
+    uint64_t hashInterned(InternedString key) const {
+        return seed == DEFAULT_SEED ? StringPool::global().hash(key.getId()) : hashKey(key.view(), seed);
+    }
+    static int findSlot(const Slots& slots, std::string_view key, uint64_t hash, int* steps = nullptr);
+    static int findSlot(const Slots& slots, InternedString key, uint64_t hash, int* steps = nullptr);
+    template <typename Key>
+    int findIndex(Key key, uint64_t hash, int& steps) const;
+    template <typename Key>
+    bool removeHashed(Key key, uint64_t hash);
+    static void insertHashed(Slots& slots, uint32_t keyId, int index, uint64_t hash);
+    static void eraseSlot(Slots& slots, int slot);
+    // Проверка слотов из снимка до того, как ими воспользуется таблица
+    static bool validSlots(const Slots& slots, uint32_t stringCount, const SlotMap<Animal>& animals,
+                           int expectedSize);
+
+    void buildFrom(const DynamicArray<Animal>& animals, const DynamicArray<int>* ids);
     void rehash(int newCapacity);
-    int findSlot(const std::string& key, bool forInsertion = false) const;
+    void migrate(int slotBudget) const;
+    void finishMigration() const { migrate(oldTable.capacity); }
 };
 
 #endif // ANIMAL_HASH_TABLE_H
\ No newline at end of file
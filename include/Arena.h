@@ -0,0 +1,89 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Монотонная арена: выделение - сдвиг указателя внутри текущего блока,
+// отдельные объекты не освобождаются, вся память возвращается одним reset().
+// Блоки растут геометрически; после reset() остаётся самый большой блок,
+// так что повторное заполнение того же объёма обходится без malloc
+class MonotonicArena {
+public:
+    explicit MonotonicArena(size_t initialBlockSize = 64 * 1024);
+    ~MonotonicArena();
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+    // Память возвращается, только если это последнее выделение; иначе ничего
+    void deallocate(void* ptr, size_t bytes);
+
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        return ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Деструкторы объектов не вызываются: это забота владельца
+    void reset();
+
+    size_t getBytesUsed() const { return bytesUsed; }
+    size_t getBytesReserved() const { return bytesReserved; }
+
+private:
+    struct Block {
+        Block* prev;
+        size_t size;
+    };
+
+    Block* current;
+    char* cursor;
+    char* limit;
+    size_t initialBlockSize;
+    size_t bytesUsed;
+    size_t bytesReserved;
+
+    void addBlock(size_t minBytes);
+};
+
+// Аллокатор в стиле std для контейнеров (DynamicArray и др.). Без арены
+// работает через обычный new/delete
+template<typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    ArenaAllocator() : arena(nullptr) {}
+    explicit ArenaAllocator(MonotonicArena* a) : arena(a) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.getArena()) {}
+
+    T* allocate(size_t count) {
+        if (arena) {
+            return static_cast<T*>(arena->allocate(sizeof(T) * count, alignof(T)));
+        }
+        return static_cast<T*>(::operator new(sizeof(T) * count));
+    }
+
+    void deallocate(T* ptr, size_t count) {
+        if (arena) {
+            arena->deallocate(ptr, sizeof(T) * count);
+        } else {
+            ::operator delete(ptr);
+        }
+    }
+
+    MonotonicArena* getArena() const { return arena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.getArena(); }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.getArena(); }
+
+private:
+    MonotonicArena* arena;
+};
+
+#endif // ARENA_H
@@ -1,34 +1,136 @@
 #ifndef CIRCULAR_LIST_H
 #define CIRCULAR_LIST_H
 
+#include <cstddef>
+#include <iterator>
 #include <ostream>
 
+class MonotonicArena;
+class ListNodePool;
+
+// Узлы берутся из пула, если он задан: удалённый узел уходит в список
+// свободных пула, clear() и деструктор отдают всё кольцо за O(1).
+// Копия списка всегда живёт в обычной куче.
+// Число элементов хранится, обход - через итераторы (for (int v : list)),
+// а не через get(i), который идёт от головы
 class CircularList {
+private:
+    struct Node;
+
 public:
+    // Двунаправленный итератор по кольцу; позиция отличает end() от головы
+    class const_iterator {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef int value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const int* pointer;
+        typedef const int& reference;
+
+        const_iterator() : node(nullptr), pos(0) {}
+
+        reference operator*() const { return node->data; }
+        pointer operator->() const { return &node->data; }
+        const_iterator& operator++() { node = node->next; ++pos; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+        const_iterator& operator--() { node = node->prev; --pos; return *this; }
+        const_iterator operator--(int) { const_iterator old = *this; --*this; return old; }
+        bool operator==(const const_iterator& other) const { return pos == other.pos; }
+        bool operator!=(const const_iterator& other) const { return pos != other.pos; }
+
+    private:
+        friend class CircularList;
+        const_iterator(const Node* n, int p) : node(n), pos(p) {}
+        const Node* node;
+        int pos;
+    };
+    typedef const_iterator iterator;
+
     CircularList();
+    explicit CircularList(ListNodePool* pool);
     ~CircularList();
     CircularList(const CircularList &other);
     CircularList& operator=(const CircularList &other);
+    // Перемещение забирает узлы вместе с их пулом
+    CircularList(CircularList &&other) noexcept;
+    CircularList& operator=(CircularList &&other) noexcept;
+    void swap(CircularList &other) noexcept;
 
     void clear();
     void add(int value);
+    // Дописывает копии элементов other в хвост; сам список не обходится
+    void append(const CircularList &other);
+    // Переносит узлы other в хвост за O(1), other становится пустым.
+    // При разных пулах узлы копируются
+    void splice(CircularList &other);
     void removeAll(int value);
     void removeBeforeValue(int value);
     int get(int index) const;
     int find(int value) const;
-    int size() const;
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
     int toNumber() const;
     void print(std::ostream &out) const;
 
+    const_iterator begin() const { return const_iterator(head, 0); }
+    const_iterator end() const { return const_iterator(head, count); }
+
 private:
+    friend class ListNodePool;
+
     struct Node {
         int data;
         Node *next, *prev;
         explicit Node(int d);
     };
     Node *head;
+    int count;
+    ListNodePool* pool;
 
+    Node* createNode(int value);
+    void destroyNode(Node* node);
     void copyFrom(const CircularList &other);
 };
 
+// Пул узлов для списков одного дерева. Узлы нарезаются из плит по
+// nodesPerSlab штук подряд, поэтому элементы, добавленные друг за другом,
+// лежат рядом в памяти. Освобождённые узлы собираются в список свободных
+// и выдаются первыми. С ареной плиты берутся из неё, и reset() только
+// забывает их; без арены reset() освобождает каждую плиту целиком
+class ListNodePool {
+public:
+    explicit ListNodePool(MonotonicArena* arena = nullptr, int nodesPerSlab = 256);
+    ~ListNodePool();
+
+    ListNodePool(const ListNodePool&) = delete;
+    ListNodePool& operator=(const ListNodePool&) = delete;
+
+    // Все списки пула должны быть уже пусты или больше не использоваться
+    void reset();
+
+    int getNodesInUse() const { return nodesInUse; }
+    int getSlabCount() const { return slabCount; }
+
+private:
+    friend class CircularList;
+
+    struct Slab {
+        Slab* prev;
+    };
+
+    MonotonicArena* arena;
+    int nodesPerSlab;
+    Slab* slabs;
+    CircularList::Node* cursor;
+    CircularList::Node* limit;
+    CircularList::Node* freeHead;
+    int nodesInUse;
+    int slabCount;
+
+    void* allocate();
+    // Возвращает цепочку first..last (по next) из count узлов
+    void release(CircularList::Node* first, CircularList::Node* last, int count);
+    void addSlab();
+};
+
 #endif // CIRCULAR_LIST_H
@@ -0,0 +1,26 @@
+#ifndef DATE_UTILS_H
+#define DATE_UTILS_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Даты хранятся номером дня (0 - 01.01.1970 по григорианскому календарю):
+// сравнение и диапазоны - обычные целые, текст разбирается один раз при вводе
+namespace DateUtils {
+    const int MIN_YEAR = 1900;
+    const int MAX_YEAR = 2100;
+
+    // Строго DD.MM.YYYY с проверкой числа дней в месяце; ложь - дата некорректна
+    bool parseDate(std::string_view text, int32_t& dayNumber);
+
+    bool isValidDateFormat(std::string_view text);
+
+    // Обратно в DD.MM.YYYY
+    std::string formatDate(int32_t dayNumber);
+
+    int32_t daysFromCivil(int year, int month, int day);
+    void civilFromDays(int32_t dayNumber, int& year, int& month, int& day);
+}
+
+#endif // DATE_UTILS_H
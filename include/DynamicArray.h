@@ -3,52 +3,143 @@
 
 #include <utility>
 #include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Политики роста ёмкости: next() возвращает новую ёмкость не меньше required
+struct DoublingGrowth {
+    static size_t next(size_t capacity, size_t required) {
+        size_t grown = (capacity == 0) ? 8 : capacity * 2;
+        return grown < required ? required : grown;
+    }
+};
+
+// Рост в 1.5 раза: меньше перерасход памяти, освобождённые блоки можно переиспользовать
+struct GoldenGrowth {
+    static size_t next(size_t capacity, size_t required) {
+        size_t grown = (capacity < 8) ? 8 : capacity + capacity / 2;
+        return grown < required ? required : grown;
+    }
+};
 
-template <typename T>
+// Память выделяется без конструирования: элементы создаются placement-new
+// только в занятой части, лишняя ёмкость остаётся сырой. Тривиально
+// копируемые типы переносятся при росте одним memcpy.
+// Alloc - аллокатор в стиле std (например, ArenaAllocator из Arena.h). Копия
+// массива получает аллокатор по умолчанию, перемещение забирает аллокатор источника
+template <typename T, typename Growth = DoublingGrowth, typename Alloc = std::allocator<T>>
 class DynamicArray {
 private:
     T* m_data;
     size_t m_size;
     size_t m_capacity;
+    Alloc m_alloc;
 
-    void reallocate(size_t new_capacity) {
-        T* new_data = new T[new_capacity];
-        for (size_t i = 0; i < m_size; ++i) {
-            new_data[i] = std::move(m_data[i]);
+    static constexpr bool RELOCATE_BY_MEMCPY = std::is_trivially_copyable<T>::value;
+
+    T* allocate(size_t capacity) {
+        return capacity ? m_alloc.allocate(capacity) : nullptr;
+    }
+
+    void deallocate(T* data, size_t capacity) {
+        if (data) {
+            m_alloc.deallocate(data, capacity);
+        }
+    }
+
+    static void destroy(T* first, T* last) {
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            for (; first != last; ++first) {
+                first->~T();
+            }
+        }
+    }
+
+    // Переносит count элементов из src в неинициализированную память dst
+    static void relocate(T* src, size_t count, T* dst) {
+        if (count == 0) {
+            return;
+        }
+        if constexpr (RELOCATE_BY_MEMCPY) {
+            std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(T));
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                ::new (static_cast<void*>(dst + i)) T(std::move(src[i]));
+                src[i].~T();
+            }
         }
-        delete[] m_data;
+    }
+
+    void reallocate(size_t new_capacity) {
+        T* new_data = allocate(new_capacity);
+        relocate(m_data, m_size, new_data);
+        deallocate(m_data, m_capacity);
         m_data = new_data;
         m_capacity = new_capacity;
     }
 
+    // Новый элемент строится в новом буфере до переноса старых: аргумент
+    // может ссылаться на элемент этого же массива
+    template <typename... Args>
+    T& growAndEmplace(Args&&... args) {
+        size_t new_capacity = Growth::next(m_capacity, m_size + 1);
+        T* new_data = allocate(new_capacity);
+        ::new (static_cast<void*>(new_data + m_size)) T(std::forward<Args>(args)...);
+        relocate(m_data, m_size, new_data);
+        deallocate(m_data, m_capacity);
+        m_data = new_data;
+        m_capacity = new_capacity;
+        return m_data[m_size++];
+    }
+
+    void copyFrom(const DynamicArray& other) {
+        m_data = allocate(other.m_capacity);
+        m_capacity = other.m_capacity;
+        if constexpr (RELOCATE_BY_MEMCPY) {
+            if (other.m_size) {
+                std::memcpy(static_cast<void*>(m_data), static_cast<const void*>(other.m_data), other.m_size * sizeof(T));
+            }
+        } else {
+            for (size_t i = 0; i < other.m_size; ++i) {
+                ::new (static_cast<void*>(m_data + i)) T(other.m_data[i]);
+            }
+        }
+        m_size = other.m_size;
+    }
+
+    void release() {
+        destroy(m_data, m_data + m_size);
+        deallocate(m_data, m_capacity);
+        m_data = nullptr;
+        m_size = 0;
+        m_capacity = 0;
+    }
+
 public:
-    DynamicArray() : m_data(nullptr), m_size(0), m_capacity(0) {}
+    DynamicArray() : m_data(nullptr), m_size(0), m_capacity(0), m_alloc() {}
+
+    explicit DynamicArray(const Alloc& alloc) : m_data(nullptr), m_size(0), m_capacity(0), m_alloc(alloc) {}
 
     ~DynamicArray() {
-        delete[] m_data;
+        release();
     }
 
-    DynamicArray(const DynamicArray& other) : m_size(other.m_size), m_capacity(other.m_capacity) {
-        m_data = new T[m_capacity];
-        for (size_t i = 0; i < m_size; ++i) {
-            m_data[i] = other.m_data[i];
-        }
+    DynamicArray(const DynamicArray& other) : m_data(nullptr), m_size(0), m_capacity(0), m_alloc() {
+        copyFrom(other);
     }
 
     DynamicArray& operator=(const DynamicArray& other) {
         if (this != &other) {
-            delete[] m_data;
-            m_size = other.m_size;
-            m_capacity = other.m_capacity;
-            m_data = new T[m_capacity];
-            for (size_t i = 0; i < m_size; ++i) {
-                m_data[i] = other.m_data[i];
-            }
+            release();
+            copyFrom(other);
         }
         return *this;
     }
 
-    DynamicArray(DynamicArray&& other) noexcept : m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity) {
+    DynamicArray(DynamicArray&& other) noexcept
+        : m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity), m_alloc(other.m_alloc) {
         other.m_data = nullptr;
         other.m_size = 0;
         other.m_capacity = 0;
@@ -56,10 +147,11 @@ public:
 
     DynamicArray& operator=(DynamicArray&& other) noexcept {
         if (this != &other) {
-            delete[] m_data;
+            release();
             m_data = other.m_data;
             m_size = other.m_size;
             m_capacity = other.m_capacity;
+            m_alloc = other.m_alloc;
             other.m_data = nullptr;
             other.m_size = 0;
             other.m_capacity = 0;
@@ -67,19 +159,21 @@ public:
         return *this;
     }
 
-    void push_back(const T& value) {
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
         if (m_size >= m_capacity) {
-            size_t new_capacity = (m_capacity == 0) ? 8 : m_capacity * 2;
-            reallocate(new_capacity);
+            return growAndEmplace(std::forward<Args>(args)...);
         }
-        m_data[m_size++] = value;
+        ::new (static_cast<void*>(m_data + m_size)) T(std::forward<Args>(args)...);
+        return m_data[m_size++];
     }
-     void push_back(T&& value) {
-        if (m_size >= m_capacity) {
-            size_t new_capacity = (m_capacity == 0) ? 8 : m_capacity * 2;
-            reallocate(new_capacity);
-        }
-        m_data[m_size++] = std::move(value);
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
     }
 
     void erase(size_t index) {
@@ -90,6 +184,14 @@ public:
             m_data[i] = std::move(m_data[i + 1]);
         }
         --m_size;
+        destroy(m_data + m_size, m_data + m_size + 1);
+    }
+
+    void pop_back() {
+        if (m_size > 0) {
+            --m_size;
+            destroy(m_data + m_size, m_data + m_size + 1);
+        }
     }
 
     void reserve(size_t new_capacity) {
@@ -98,7 +200,23 @@ public:
         }
     }
 
+    // Отдаёт лишнюю ёмкость; пустой массив освобождает буфер целиком
+    void shrink_to_fit() {
+        if (m_size == m_capacity) {
+            return;
+        }
+        if (m_size == 0) {
+            deallocate(m_data, m_capacity);
+            m_data = nullptr;
+            m_capacity = 0;
+            return;
+        }
+        reallocate(m_size);
+    }
+
+    // Ёмкость сохраняется
     void clear() {
+        destroy(m_data, m_data + m_size);
         m_size = 0;
     }
 
@@ -110,13 +228,24 @@ public:
         return m_data[index];
     }
 
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+    T* begin() { return m_data; }
+    T* end() { return m_data + m_size; }
+    const T* begin() const { return m_data; }
+    const T* end() const { return m_data + m_size; }
+
     size_t size() const {
         return m_size;
     }
 
+    size_t capacity() const {
+        return m_capacity;
+    }
+
     bool empty() const {
         return m_size == 0;
     }
 };
 
-#endif // DYNAMIC_ARRAY_H
\ No newline at end of file
+#endif // DYNAMIC_ARRAY_H
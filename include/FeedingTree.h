@@ -1,50 +1,92 @@
 #ifndef FEEDING_TREE_H
 #define FEEDING_TREE_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include "DynamicArray.h"
 #include <ostream>
 #include "CircularList.h"
+#include "PostingsView.h"
+#include "StringPool.h"
+#include "Arena.h"
+
+class AnimalHashTable;
 
 struct FeedingEntry {
-    std::string nickname;
-    std::string feedType;
+    InternedString nickname;
+    InternedString feedType;
     int quantity;
-    std::string date;
+    int32_t date; // номер дня, см. DateUtils
 };
 
 struct FeedingNode {
-    std::string key;
+    InternedString key;
     int balance;
     FeedingNode *left, *right;
     CircularList indices;
 
-    FeedingNode(std::string k, int idx);
+    FeedingNode(InternedString k, int idx, ListNodePool* pool = nullptr);
 };
 
 class FeedingTree {
 public:
-    FeedingTree();
+    // Списки узлов берут память из общего пула дерева. С ареной узлы и плиты
+    // пула живут в ней, удалённые узлы переиспользуются, clear() только
+    // забывает корень
+    explicit FeedingTree(MonotonicArena* arena = nullptr);
     ~FeedingTree();
 
-    void add(const std::string& nickname, int index);
-    void remove(const std::string& nickname, int index);
-    CircularList search(const std::string& nickname) const;
+    void add(InternedString nickname, int index);
+    void remove(InternedString nickname, int index);
+
+    struct BuildEntry {
+        InternedString key;
+        int index;
+    };
+    // Перестройка за O(n) из записей, отсортированных по (key, index):
+    // идеально сбалансированное дерево снизу вверх, прежнее содержимое удаляется
+    void buildFromSorted(const BuildEntry* entries, size_t count);
+    // Взгляд на список узла, действителен до изменения дерева
+    PostingsView<CircularList> search(std::string_view nickname) const;
 
     void print(std::ostream &out) const;
 
-    bool importFromFile(const std::string &filename, DynamicArray<FeedingEntry> &outEntries, int maxLines = 0);
+    // Если задан knownAnimals, строки с неизвестной кличкой пропускаются
+    // и считаются в skippedUnknown
+    bool importFromFile(const std::string &filename, DynamicArray<FeedingEntry> &outEntries, int maxLines = 0,
+                        const AnimalHashTable* knownAnimals = nullptr, int* skippedUnknown = nullptr);
+    // Разбор кусками в несколько потоков; записи дописываются в порядке файла.
+    // Каждый поток сворачивает строки куска в локальные id, так что в общий
+    // пул однопоточно добавляются только различные строки. Если задан
+    // knownAnimals, строки с неизвестной кличкой пропускаются и считаются
+    // в skippedUnknown. threadCount = 0 - по числу ядер; при одном потоке -
+    // то же, что importFromFile
+    bool importFromFileParallel(const std::string &filename, DynamicArray<FeedingEntry> &outEntries,
+                                const AnimalHashTable* knownAnimals = nullptr,
+                                int* skippedUnknown = nullptr, int threadCount = 0);
     bool exportToFile(const std::string &filename, const DynamicArray<FeedingEntry>& feedings) const;
 
     void clear();
 
 private:
+    // Высота AVL-дерева не больше 1.44 log2(n), 64 уровней хватает с запасом
+    static const int MAX_DEPTH = 64;
+
     FeedingNode* root;
+    MonotonicArena* arena;
+    // С ареной: память удалённых узлов для повторного использования
+    void* freeNodes;
+    ListNodePool listPool;
+
+    FeedingNode* createNode(InternedString key, int index);
+    void destroyNode(FeedingNode* node);
 
-    FeedingNode* insertNode(FeedingNode* node, const std::string& key, int index, bool &heightInc);
-    FeedingNode* deleteNode(FeedingNode* node, const std::string& key, int index, bool &heightDec);
+    FeedingNode* buildRange(const BuildEntry* entries, const size_t* groupStarts, size_t lo, size_t hi, int &height);
     FeedingNode* rotateLeft(FeedingNode* a);
     FeedingNode* rotateRight(FeedingNode* a);
+    FeedingNode* rotateLeftRight(FeedingNode* a);
+    FeedingNode* rotateRightLeft(FeedingNode* a);
 
     FeedingNode* balanceLeftInsert(FeedingNode* node, bool &heightInc);
     FeedingNode* balanceRightInsert(FeedingNode* node, bool &heightInc);
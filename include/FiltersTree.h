@@ -1,60 +1,146 @@
 #ifndef FILTERS_TREE_H
 #define FILTERS_TREE_H
 
+#include <cstdint>
 #include <ostream>
 #include <string>
-#include "CircularList.h"
+#include <string_view>
+#include "PostingList.h"
+#include "PostingsView.h"
+#include "StringPool.h"
+#include "Arena.h"
 
 template<typename T>
 struct FilterNode {
     T key;
     int balance;
     FilterNode *left, *right;
-    CircularList indices;
+    PostingList indices;
+    // Сумма весов своих номеров и агрегаты всего поддерева (вместе с узлом)
+    long long weight;
+    int subtreeCount;
+    long long subtreeSum;
 
-    FilterNode(const T& k, int idx);
+    FilterNode(const T& k, int idx, long long w);
+};
+
+// Тип ключа для поиска: строковые деревья ищут по string_view без временных std::string.
+// probe() переводит его в значение, сравнимое с ключами узлов
+template<typename T>
+struct FilterKeyView {
+    typedef const T& type;
+    typedef const T& probe_type;
+    static const T& probe(const T& value) { return value; }
+};
+
+template<>
+struct FilterKeyView<std::string> {
+    typedef std::string_view type;
+    typedef std::string_view probe_type;
+    static std::string_view probe(std::string_view value) { return value; }
+};
+
+// Ключи из пула упорядочены по тексту, поэтому граница диапазона сравнивается
+// как есть и не обязана быть в пуле
+template<>
+struct FilterKeyView<InternedString> {
+    typedef std::string_view type;
+    typedef std::string_view probe_type;
+    static std::string_view probe(std::string_view value) { return value; }
 };
 
 template<typename T>
 class FiltersTree {
 public:
-    FiltersTree();
+    typedef typename FilterKeyView<T>::type KeyView;
+    typedef typename FilterKeyView<T>::probe_type ProbeKey;
+
+    // Номера в узле хранятся сжатым отсортированным PostingList. С ареной
+    // в ней живут сами узлы: удалённые узлы переиспользуются, clear() обходит
+    // дерево только ради деструкторов списков и ключей, память узлов
+    // возвращает reset() владельца арены
+    explicit FiltersTree(MonotonicArena* arena = nullptr);
     ~FiltersTree();
 
-    void add(const T& filterValue, int index);
-    void remove(const T& filterValue, int index);
-    CircularList search(const T& filterValue) const;
-    CircularList searchInRange(const T& minValue, const T& maxValue) const;
-    CircularList getAllIndices() const;
-    void print(std::ostream &out) const;
+    // weight - значение, которое суммирует sumInRange (например, количество
+    // кормлений). При удалении передаётся тот же вес, что и при добавлении
+    void add(const T& filterValue, int index, long long weight = 0);
+    void remove(const T& filterValue, int index, long long weight = 0);
+
+    struct BuildEntry {
+        T key;
+        int index;
+        long long weight;
+    };
+    // Перестройка за O(n) из записей, отсортированных по (key, index): равные
+    // ключи собираются в один список, дерево строится идеально сбалансированным
+    // снизу вверх без поворотов. Прежнее содержимое удаляется
+    void buildFromSorted(const BuildEntry* entries, size_t count);
+    // Результаты - взгляды на списки узлов, действительны до изменения дерева
+    PostingsView<PostingList> search(KeyView filterValue) const;
+    PostingsView<PostingList> searchInRange(KeyView minValue, KeyView maxValue) const;
+    PostingsView<PostingList> getAllIndices() const;
+    // Список номеров ключа (nullptr, если ключа нет) - для PostingList::intersect
+    const PostingList* findPostings(KeyView filterValue) const;
+    // Число номеров и сумма их весов по ключам из [minValue, maxValue] за O(log n):
+    // по агрегатам поддеревьев, без обхода списков
+    int countInRange(KeyView minValue, KeyView maxValue) const;
+    long long sumInRange(KeyView minValue, KeyView maxValue) const;
+
+    // Порядковые запросы: номера упорядочены по ключу, внутри ключа - по возрастанию.
+    // Позиция находится спуском по числу номеров в поддеревьях за O(log n)
+    int size() const { return root ? root->subtreeCount : 0; }
+    // Сколько номеров с ключом меньше filterValue
+    int rank(KeyView filterValue) const;
+    // Номер на позиции position или -1
+    int select(int position) const;
+    // Страница из не более limit номеров начиная с позиции offset: O(log n + limit)
+    void page(int offset, int limit, DynamicArray<int> &out) const;
+    // То же среди номеров с ключами из [minValue, maxValue]
+    void rangePage(KeyView minValue, KeyView maxValue, int offset, int limit, DynamicArray<int> &out) const;
+    // formatKey - вывод ключа в читаемом виде (например, номер дня как дата)
+    typedef std::string (*KeyFormatter)(T);
+    void print(std::ostream &out, KeyFormatter formatKey = nullptr) const;
     void clear();
     bool empty() const { return root == nullptr; }
 
 private:
+    // Высота AVL-дерева не больше 1.44 log2(n), 64 уровней хватает с запасом
+    static const int MAX_DEPTH = 64;
+
     FilterNode<T>* root;
+    MonotonicArena* arena;
+    // С ареной: память удалённых узлов для повторного использования (как у
+    // ListNodePool), иначе удаления по одному копили бы её до reset()
+    void* freeNodes;
+
+    FilterNode<T>* createNode(const T& key, int index, long long weight);
+    void destroyNode(FilterNode<T>* node);
 
-    FilterNode<T>* insertNode(FilterNode<T>* node, const T& key, int index, bool &heightInc);
-    FilterNode<T>* deleteNode(FilterNode<T>* node, const T& key, int index, bool &heightDec);
+    // Узел для групп ключей [lo, hi): groupStarts[g] - первая запись группы g
+    FilterNode<T>* buildRange(const BuildEntry* entries, const size_t* groupStarts, size_t lo, size_t hi, int &height);
+    // Пересчёт агрегатов узла по детям; вызывается снизу вверх
+    static void pull(FilterNode<T>* node);
+    // Агрегаты номеров с ключом < bound (или <= bound при inclusive)
+    void prefixAggregate(ProbeKey bound, bool inclusive, int &count, long long &sum) const;
+    // Дописывает в out count номеров начиная с позиции position
+    void collectFrom(int position, int count, DynamicArray<int> &out) const;
     FilterNode<T>* rotateLeft(FilterNode<T>* a);
     FilterNode<T>* rotateRight(FilterNode<T>* a);
+    FilterNode<T>* balanceLeftInsert(FilterNode<T>* node, bool &heightInc);
+    FilterNode<T>* balanceRightInsert(FilterNode<T>* node, bool &heightInc);
     FilterNode<T>* balanceLeft(FilterNode<T>* node, bool &heightDec);
     FilterNode<T>* balanceRight(FilterNode<T>* node, bool &heightDec);
-    void prettyPrint(FilterNode<T>* node, std::ostream &out, const std::string& prefix, bool isLast, int level) const;
-    void inOrderCollect(FilterNode<T>* node, CircularList &result) const;
-    void rangeSearch(FilterNode<T>* node, const T& minVal, const T& maxVal, CircularList &result) const;
+    void prettyPrint(FilterNode<T>* node, std::ostream &out, const std::string& prefix, bool isLast, int level,
+                     KeyFormatter formatKey) const;
+    void inOrderCollect(FilterNode<T>* node, PostingsView<PostingList> &result) const;
+    void rangeSearch(FilterNode<T>* node, ProbeKey minVal, ProbeKey maxVal, PostingsView<PostingList> &result) const;
     void clearNode(FilterNode<T>* node);
 };
 
 typedef FiltersTree<double> PriceFiltersTree;
 typedef FiltersTree<int> QuantityFiltersTree;
-typedef FiltersTree<std::string> DateFiltersTree;
-
-namespace DateUtils {
-    std::string normalizeDateForComparison(const std::string& date);
-
-    bool isValidDateFormat(const std::string& date);
-
-    int compareDates(const std::string& date1, const std::string& date2);
-}
+typedef FiltersTree<int32_t> DateFiltersTree;
+typedef FiltersTree<InternedString> SpeciesFiltersTree;
 
 #endif // FILTERS_TREE_H
\ No newline at end of file
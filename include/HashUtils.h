@@ -0,0 +1,43 @@
+#ifndef HASH_UTILS_H
+#define HASH_UTILS_H
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace HashUtils {
+    constexpr uint64_t DEFAULT_SEED = 0x9E3779B97F4A7C15ULL;
+
+    inline uint64_t mix64(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xFF51AFD7ED558CCDULL;
+        x ^= x >> 33;
+        x *= 0xC4CEB9FE1A85EC53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    // 64-битный хеш строки с затравкой: по 8 байт за шаг, хвост добивается длиной
+    inline uint64_t hashBytes(std::string_view key, uint64_t seed) {
+        const size_t len = key.length();
+        const char* data = key.data();
+        uint64_t hash = seed ^ (len * 0x9E3779B97F4A7C15ULL);
+
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            uint64_t chunk;
+            std::memcpy(&chunk, data + i, 8);
+            hash = (hash ^ mix64(chunk)) * 0x9E3779B97F4A7C15ULL;
+        }
+
+        uint64_t tail = 0;
+        for (size_t j = 0; i + j < len; ++j) {
+            tail |= static_cast<uint64_t>(static_cast<unsigned char>(data[i + j])) << (8 * j);
+        }
+        hash = (hash ^ mix64(tail ^ len)) * 0x9E3779B97F4A7C15ULL;
+
+        return mix64(hash);
+    }
+}
+
+#endif // HASH_UTILS_H
@@ -0,0 +1,88 @@
+#ifndef POSTING_LIST_H
+#define POSTING_LIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include "DynamicArray.h"
+
+// Отсортированный список номеров записей без повторов для индексов-фильтров.
+// Номера лежат блоками до BLOCK_SIZE штук: первый номер блока хранится
+// целиком, остальные - разностями с предыдущим в varint (обычно 1-2 байта
+// вместо узла списка). Первый и последний номер блока служат указателями
+// пропуска: поиск и пересечение перескакивают блоки, не распаковывая их
+class PostingList {
+public:
+    static const int BLOCK_SIZE = 128;
+
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef int value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const int* pointer;
+        typedef const int& reference;
+
+        const_iterator() : list(nullptr), block(0), inBlock(0), offset(0), value(0), pos(0) {}
+
+        reference operator*() const { return value; }
+        pointer operator->() const { return &value; }
+        const_iterator& operator++();
+        const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+        bool operator==(const const_iterator& other) const { return pos == other.pos; }
+        bool operator!=(const const_iterator& other) const { return pos != other.pos; }
+
+    private:
+        friend class PostingList;
+        const PostingList* list;
+        size_t block;
+        int inBlock;
+        size_t offset;
+        int value;
+        int pos;
+    };
+    typedef const_iterator iterator;
+
+    PostingList() : total(0) {}
+
+    // Повторное добавление номера ничего не меняет
+    void add(int id);
+    void remove(int id);
+    bool contains(int id) const;
+    void clear();
+    void swap(PostingList& other) noexcept;
+
+    int size() const { return total; }
+    bool empty() const { return total == 0; }
+    // Память заголовков и разностей, без самого объекта
+    size_t getBytesUsed() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    // Итератор на position-й номер по возрастанию (end(), если его нет).
+    // Целые блоки пропускаются по заголовкам, распаковывается только нужный
+    const_iterator iteratorAt(int position) const;
+
+    // Общие номера a и b по возрастанию дописываются в out
+    static void intersect(const PostingList& a, const PostingList& b, DynamicArray<int>& out);
+
+private:
+    struct Block {
+        int first;
+        int last;
+        int count;
+        DynamicArray<uint8_t> deltas;
+    };
+
+    DynamicArray<Block> blocks;
+    int total;
+
+    // Последний блок с first <= id (0, если id меньше всех)
+    size_t findBlock(int id) const;
+    static int decode(const Block& block, int* out);
+    static void encode(Block& block, const int* ids, int count);
+    static void appendVarint(DynamicArray<uint8_t>& bytes, uint32_t value);
+    static uint32_t readVarint(const DynamicArray<uint8_t>& bytes, size_t& offset);
+};
+
+#endif // POSTING_LIST_H
@@ -0,0 +1,90 @@
+#ifndef POSTINGS_VIEW_H
+#define POSTINGS_VIEW_H
+
+#include <cstddef>
+#include <iterator>
+#include "CircularList.h"
+#include "DynamicArray.h"
+
+// Невладеющий взгляд на один или несколько списков индексов (узлы дерева по
+// порядку ключей): поиск в дереве отдаёт его без копирования элементов.
+// List - CircularList или PostingList. Действителен, пока дерево не
+// меняется; toList() делает собственную копию
+template <typename List>
+class PostingsView {
+public:
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef int value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const int* pointer;
+        typedef const int& reference;
+
+        const_iterator() : view(nullptr), segment(0) {}
+
+        reference operator*() const { return *it; }
+        pointer operator->() const { return &*it; }
+        const_iterator& operator++() {
+            // Пустых сегментов нет: append() их пропускает
+            ++it;
+            if (it == view->segmentAt(segment).end()) {
+                ++segment;
+                it = segment < view->segmentCount() ? view->segmentAt(segment).begin() : typename List::const_iterator();
+            }
+            return *this;
+        }
+        const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+        bool operator==(const const_iterator& other) const { return segment == other.segment && it == other.it; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class PostingsView;
+        const_iterator(const PostingsView* v, int s, typename List::const_iterator i) : view(v), segment(s), it(i) {}
+        const PostingsView* view;
+        int segment;
+        typename List::const_iterator it;
+    };
+    typedef const_iterator iterator;
+
+    PostingsView() : first(nullptr), total(0) {}
+    explicit PostingsView(const List& list) : first(nullptr), total(0) { append(list); }
+
+    // Первый список хранится на месте, поэтому взгляд на один ключ не выделяет память
+    void append(const List& list) {
+        if (list.empty()) return;
+        if (!first) {
+            first = &list;
+        } else {
+            rest.push_back(&list);
+        }
+        total += list.size();
+    }
+
+    int size() const { return total; }
+    bool empty() const { return total == 0; }
+
+    CircularList toList() const {
+        CircularList result;
+        for (int value : *this) {
+            result.add(value);
+        }
+        return result;
+    }
+
+    const_iterator begin() const {
+        if (!first) return end();
+        return const_iterator(this, 0, first->begin());
+    }
+    const_iterator end() const { return const_iterator(this, segmentCount(), typename List::const_iterator()); }
+
+private:
+    const List* first;
+    DynamicArray<const List*> rest;
+    int total;
+
+    int segmentCount() const { return first ? 1 + static_cast<int>(rest.size()) : 0; }
+    const List& segmentAt(int i) const { return i == 0 ? *first : *rest[i - 1]; }
+};
+
+#endif // POSTINGS_VIEW_H
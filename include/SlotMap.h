@@ -0,0 +1,165 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include "DynamicArray.h"
+#include <cstdint>
+#include <utility>
+
+// Хранилище записей со стабильными номерами. Номер (id) - индекс слота: он не
+// меняется, пока запись жива, и после удаления отдаётся следующей вставке.
+// Сами записи лежат плотно для быстрого обхода; удаление переносит последнюю
+// запись на место удалённой, но её id остаётся прежним.
+// Поколение слота растёт при занятии и при освобождении (нечётное - слот занят),
+// поэтому Handle, взятый до удаления, больше не считается действительным.
+// Голый id поколения не несёт: после erase(id) тот же id получит следующая
+// вставка, и старая ссылка молча укажет на новую запись. Поэтому индексы,
+// хранящие id, снимают запись до erase (так делает ZooCatalog), а ссылку,
+// которая может пережить удаление, держат как Handle и проверяют isValid().
+template <typename T>
+class SlotMap {
+public:
+    struct Handle {
+        int id;
+        uint32_t generation;
+    };
+
+    SlotMap() : freeHead(NO_SLOT) {}
+
+    int insert(const T& value) {
+        int id;
+        if (freeHead != NO_SLOT) {
+            id = freeHead;
+            freeHead = static_cast<int>(slots[id].dense);
+        } else {
+            id = static_cast<int>(slots.size());
+            slots.push_back(Slot{0, 0});
+        }
+        slots[id].dense = static_cast<uint32_t>(values.size());
+        slots[id].generation++;
+        values.push_back(value);
+        valueIds.push_back(id);
+        return id;
+    }
+
+    void erase(int id) {
+        if (!contains(id)) {
+            return;
+        }
+        uint32_t dense = slots[id].dense;
+        uint32_t last = static_cast<uint32_t>(values.size() - 1);
+        if (dense != last) {
+            values[dense] = std::move(values[last]);
+            valueIds[dense] = valueIds[last];
+            slots[valueIds[dense]].dense = dense;
+        }
+        values.pop_back();
+        valueIds.pop_back();
+
+        slots[id].generation++;
+        slots[id].dense = static_cast<uint32_t>(freeHead);
+        freeHead = id;
+    }
+
+    bool contains(int id) const {
+        return id >= 0 && id < static_cast<int>(slots.size()) && (slots[id].generation & 1u);
+    }
+
+    bool isValid(Handle handle) const {
+        return contains(handle.id) && slots[handle.id].generation == handle.generation;
+    }
+
+    Handle handle(int id) const { return Handle{id, slots[id].generation}; }
+
+    T& get(int id) { return values[slots[id].dense]; }
+    const T& get(int id) const { return values[slots[id].dense]; }
+
+    // Плотный обход: позиции 0..size()-1, порядок меняется при удалениях
+    size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+    T& valueAt(size_t position) { return values[position]; }
+    const T& valueAt(size_t position) const { return values[position]; }
+    int idAt(size_t position) const { return valueIds[position]; }
+
+    // Все id меньше slotCount()
+    int slotCount() const { return static_cast<int>(slots.size()); }
+    uint32_t generationOf(int id) const { return slots[id].generation; }
+
+    const DynamicArray<T>& denseValues() const { return values; }
+    const DynamicArray<int>& denseIds() const { return valueIds; }
+
+    void reserve(size_t capacity) {
+        values.reserve(capacity);
+        valueIds.reserve(capacity);
+        slots.reserve(capacity);
+    }
+
+    // Слоты остаются с новым поколением, чтобы старые Handle не ожили
+    void clear() {
+        values.clear();
+        valueIds.clear();
+        freeHead = NO_SLOT;
+        for (int id = static_cast<int>(slots.size()) - 1; id >= 0; --id) {
+            if (slots[id].generation & 1u) {
+                slots[id].generation++;
+            }
+            slots[id].dense = static_cast<uint32_t>(freeHead);
+            freeHead = id;
+        }
+    }
+
+    // Восстановление из снимка: записи, их id и поколения всех слотов.
+    // Ложь - id вне диапазона или его поколение не совпадает с занятостью слота
+    bool restore(DynamicArray<T>&& newValues, DynamicArray<int>&& newIds,
+                 const DynamicArray<uint32_t>& generations) {
+        if (newValues.size() != newIds.size()) {
+            return false;
+        }
+        DynamicArray<Slot> newSlots;
+        newSlots.reserve(generations.size());
+        for (size_t id = 0; id < generations.size(); ++id) {
+            newSlots.push_back(Slot{NO_POSITION, generations[id]});
+        }
+        for (size_t i = 0; i < newIds.size(); ++i) {
+            int id = newIds[i];
+            if (id < 0 || id >= static_cast<int>(newSlots.size()) ||
+                !(newSlots[id].generation & 1u) || newSlots[id].dense != NO_POSITION) {
+                return false;
+            }
+            newSlots[id].dense = static_cast<uint32_t>(i);
+        }
+        int head = NO_SLOT;
+        for (int id = static_cast<int>(newSlots.size()) - 1; id >= 0; --id) {
+            if (newSlots[id].generation & 1u) {
+                if (newSlots[id].dense == NO_POSITION) {
+                    return false;
+                }
+                continue;
+            }
+            newSlots[id].dense = static_cast<uint32_t>(head);
+            head = id;
+        }
+
+        values = std::move(newValues);
+        valueIds = std::move(newIds);
+        slots = std::move(newSlots);
+        freeHead = head;
+        return true;
+    }
+
+private:
+    // dense - позиция записи у занятого слота или следующий свободный слот
+    struct Slot {
+        uint32_t dense;
+        uint32_t generation;
+    };
+
+    static const int NO_SLOT = -1;
+    static const uint32_t NO_POSITION = 0xFFFFFFFFu;
+
+    DynamicArray<T> values;
+    DynamicArray<int> valueIds;
+    DynamicArray<Slot> slots;
+    int freeHead;
+};
+
+#endif // SLOT_MAP_H
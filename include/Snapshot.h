@@ -0,0 +1,32 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "AnimalHashTable.h"
+#include "FeedingTree.h"
+#include "SlotMap.h"
+#include <cstdint>
+#include <string>
+
+// Бинарный снимок справочников: пул строк, записи животных и кормлений вместе
+// с их id и поколениями слотов, и готовые массивы слотов хеш-таблицы.
+// Загружается через отображение файла в память без разбора текста и без
+// перестроения хеш-таблицы; id записей после загрузки те же, что до сохранения. Порядок байтов - родной для машины.
+// Деревья индексов в снимок не входят: ZooCatalog строит их из записей
+// после загрузки (сортировка и buildFromSorted, O(n log n)).
+// Текстовые importFromFile/exportToFile остаются форматом обмена.
+namespace Snapshot {
+    // 3: дата кормления - номер дня, а не строка пула
+    constexpr uint32_t VERSION = 3;
+
+    bool save(const std::string& filename,
+              const SlotMap<Animal>& animals,
+              const SlotMap<FeedingEntry>& feedings,
+              AnimalHashTable& animalTable);
+
+    bool load(const std::string& filename,
+              SlotMap<Animal>& animals,
+              SlotMap<FeedingEntry>& feedings,
+              AnimalHashTable& animalTable);
+}
+
+#endif // SNAPSHOT_H
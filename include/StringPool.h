@@ -0,0 +1,117 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include "DynamicArray.h"
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Пул интернированных строк: каждая различная строка хранится один раз
+// и получает постоянный 32-битный id. Текст не перемещается, пока жив пул.
+class StringPool {
+public:
+    static constexpr uint32_t NO_ID = 0xFFFFFFFFu;
+
+    StringPool();
+    ~StringPool();
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    uint32_t intern(std::string_view text);
+    uint32_t find(std::string_view text) const;
+
+    std::string_view view(uint32_t id) const {
+        return id < lengths.size() ? std::string_view(texts[id], lengths[id]) : std::string_view();
+    }
+    const char* c_str(uint32_t id) const { return id < lengths.size() ? texts[id] : ""; }
+    // Хеш текста с HashUtils::DEFAULT_SEED, сохранённый при интернировании
+    uint64_t hash(uint32_t id) const { return hashes[id]; }
+    size_t size() const { return lengths.size(); }
+
+    static StringPool& global();
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    DynamicArray<char*> blocks;
+    size_t blockUsed;
+    size_t blockCapacity;
+
+    DynamicArray<const char*> texts;
+    DynamicArray<uint32_t> lengths;
+    DynamicArray<uint64_t> hashes;
+
+    // Открытая адресация по id, пустой слот = NO_ID
+    uint32_t* lookup;
+    uint32_t lookupCapacity;
+
+    const char* store(std::string_view text);
+    void growLookup();
+};
+
+// Ссылка на строку пула. Равенство сравнивает id (равные строки имеют один id),
+// порядок - текст, поэтому деревья с такими ключами упорядочены по строкам
+// и запросы по диапазону и позиции в них осмысленны.
+class InternedString {
+public:
+    InternedString() : id(0) {}
+    InternedString(std::string_view text) : id(StringPool::global().intern(text)) {}
+    InternedString(const char* text) : id(StringPool::global().intern(text)) {}
+    InternedString(const std::string& text) : id(StringPool::global().intern(text)) {}
+
+    static InternedString fromId(uint32_t id) { InternedString s; s.id = id; return s; }
+    // Поиск без добавления: для отсутствующей строки isValid() == false
+    static InternedString lookup(std::string_view text) { return fromId(StringPool::global().find(text)); }
+
+    uint32_t getId() const { return id; }
+    bool isValid() const { return id != StringPool::NO_ID; }
+    bool empty() const { return view().empty(); }
+    std::string_view view() const { return StringPool::global().view(id); }
+    const char* c_str() const { return StringPool::global().c_str(id); }
+    std::string str() const { return std::string(view()); }
+
+    friend bool operator==(InternedString a, InternedString b) { return a.id == b.id; }
+    friend bool operator!=(InternedString a, InternedString b) { return a.id != b.id; }
+    friend bool operator<(InternedString a, InternedString b) { return a.id != b.id && a.view() < b.view(); }
+    friend bool operator>(InternedString a, InternedString b) { return b < a; }
+
+private:
+    uint32_t id;
+};
+
+template <typename S>
+using EnableIfText = typename std::enable_if<
+    std::is_convertible<const S&, std::string_view>::value &&
+    !std::is_same<S, InternedString>::value, bool>::type;
+
+template <typename S, EnableIfText<S> = true>
+inline bool operator==(InternedString a, const S& b) { return a.view() == std::string_view(b); }
+template <typename S, EnableIfText<S> = true>
+inline bool operator==(const S& a, InternedString b) { return std::string_view(a) == b.view(); }
+template <typename S, EnableIfText<S> = true>
+inline bool operator!=(InternedString a, const S& b) { return !(a == b); }
+template <typename S, EnableIfText<S> = true>
+inline bool operator!=(const S& a, InternedString b) { return !(a == b); }
+// Порядок строки пула и текста. Сторона InternedString - параметр шаблона, чтобы
+// std::string и string_view не приводились к ней (и не интернировались)
+template <typename I, typename S>
+using EnableIfInternedText = typename std::enable_if<
+    std::is_same<I, InternedString>::value && std::is_convertible<const S&, std::string_view>::value &&
+    !std::is_same<S, InternedString>::value, bool>::type;
+
+template <typename I, typename S, EnableIfInternedText<I, S> = true>
+inline bool operator<(const I& a, const S& b) { return a.view() < std::string_view(b); }
+template <typename S, typename I, EnableIfInternedText<I, S> = true>
+inline bool operator<(const S& a, const I& b) { return std::string_view(a) < b.view(); }
+template <typename I, typename S, EnableIfInternedText<I, S> = true>
+inline bool operator>(const I& a, const S& b) { return std::string_view(b) < a.view(); }
+template <typename S, typename I, EnableIfInternedText<I, S> = true>
+inline bool operator>(const S& a, const I& b) { return b.view() < std::string_view(a); }
+
+std::ostream& operator<<(std::ostream& out, InternedString s);
+std::istream& operator>>(std::istream& in, InternedString& s);
+
+#endif // STRING_POOL_H
@@ -0,0 +1,85 @@
+#ifndef TEXT_LOADER_H
+#define TEXT_LOADER_H
+
+#include "DynamicArray.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Разбор текстовых справочников прямо в отображённом в память файле:
+// строки и поля - это string_view на его байты, без копирования и istringstream
+namespace TextLoader {
+    // Указатель на ближайший '\n' в [begin, end) или end
+    const char* findNewline(const char* begin, const char* end);
+
+    // Делит строку на поля по пробельным символам (как operator>>). Заполняет
+    // не больше maxFields полей, остальные игнорируются; возвращает число полей
+    int splitFields(std::string_view line, std::string_view* fields, int maxFields);
+
+    // Целое поле целиком: допускается знак, лишние символы - ошибка
+    bool parseInt(std::string_view field, int& value);
+
+    template<typename LineHandler>
+    void forEachLine(const char* begin, const char* end, LineHandler handler) {
+        const char* cur = begin;
+        while (cur < end) {
+            const char* next = findNewline(cur, end);
+            if (!handler(std::string_view(cur, static_cast<size_t>(next - cur)))) {
+                return;
+            }
+            cur = next + 1;
+        }
+    }
+
+    // Делит [begin, end) на не более чем maxParts кусков, выровненных по '\n'
+    // (кусок не короче minPartSize). bounds получает count + 1 границ
+    int splitChunks(const char* begin, const char* end, int maxParts, size_t minPartSize,
+                    DynamicArray<const char*>& bounds);
+
+    // Число потоков для разбора: threadCount или число ядер
+    int workerCount(int threadCount);
+
+    // Вызывает handler(part, begin, end) для каждого куска в своём потоке;
+    // куски - целые строки, порядок part совпадает с порядком в файле
+    template<typename ChunkHandler>
+    int forEachChunkParallel(const char* begin, const char* end, int threadCount,
+                             size_t minPartSize, ChunkHandler handler) {
+        DynamicArray<const char*> bounds;
+        int parts = splitChunks(begin, end, workerCount(threadCount), minPartSize, bounds);
+        if (parts == 1) {
+            handler(0, bounds[0], bounds[1]);
+            return parts;
+        }
+
+        DynamicArray<std::thread> workers;
+        workers.reserve(parts - 1);
+        for (int part = 1; part < parts; ++part) {
+            workers.emplace_back([&handler, &bounds, part]() {
+                handler(part, bounds[part], bounds[part + 1]);
+            });
+        }
+        // Первый кусок разбирает вызывающий поток
+        handler(0, bounds[0], bounds[1]);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return parts;
+    }
+
+    // Обходит строки файла; обработчик возвращает false, чтобы остановиться
+    template<typename LineHandler>
+    bool forEachLine(const std::string& filename, LineHandler handler) {
+        MappedFile file;
+        if (!file.open(filename)) {
+            return false;
+        }
+        if (file.size() > 0) {
+            forEachLine(file.data(), file.data() + file.size(), handler);
+        }
+        return true;
+    }
+}
+
+#endif // TEXT_LOADER_H
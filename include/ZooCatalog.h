@@ -0,0 +1,86 @@
+#ifndef ZOO_CATALOG_H
+#define ZOO_CATALOG_H
+
+#include "AnimalHashTable.h"
+#include "FeedingTree.h"
+#include "FiltersTree.h"
+#include "SlotMap.h"
+#include "Arena.h"
+#include <string>
+#include <string_view>
+
+// Справочники зоопарка вместе со всеми индексами. Записи хранятся в SlotMap,
+// индексы ссылаются на их стабильные id, поэтому удаление не сдвигает чужие
+// ссылки и стоит O(1) плюс снятие собственных записей индексов. Полная
+// перестройка нужна лишь после массовой загрузки.
+// В индексах id хранятся без поколения (PostingList сжимает их как числа),
+// поэтому removeAnimal/removeFeeding снимают id со всех индексов до erase:
+// освободившийся id сразу достаётся следующей вставке. Удаление также меняет
+// порядок плотного обхода (getAnimals().valueAt): на место удалённой записи
+// встаёт последняя, так что позиции обхода между изменениями не хранятся.
+// Узлы деревьев и их списки живут в двух аренах (индексы животных и индексы
+// кормлений): перестройка сбрасывает арену целиком вместо поштучного delete.
+class ZooCatalog {
+public:
+    ZooCatalog();
+
+    const SlotMap<Animal>& getAnimals() const { return animals; }
+    const SlotMap<FeedingEntry>& getFeedings() const { return feedings; }
+    const AnimalHashTable& getAnimalTable() const { return animalTable; }
+    AnimalHashTable& getAnimalTable() { return animalTable; }
+    const FeedingTree& getFeedingTree() const { return feedingTree; }
+    const QuantityFiltersTree& getQuantityTree() const { return quantityTree; }
+    const DateFiltersTree& getDateTree() const { return dateTree; }
+    const SpeciesFiltersTree& getSpeciesTree() const { return speciesTree; }
+
+    // id животного или -1
+    int findAnimal(std::string_view nickname) const;
+    // id кормления с такими же полями или -1. Строки для поиска по вводу берутся
+    // через InternedString::lookup: отсутствующая в пуле строка - сразу -1
+    int findFeeding(const FeedingEntry& entry) const;
+
+    // id новой записи; -1, если кличка уже занята
+    int addAnimal(const Animal& animal);
+    // Удаляет животное и все его кормления; возвращает число удалённых кормлений
+    int removeAnimal(int id);
+    // id новой записи; -1, если животного с такой кличкой нет
+    int addFeeding(const FeedingEntry& entry);
+    void removeFeeding(int id);
+
+    // Массовая загрузка: строки дописываются, индексы перестраиваются один раз
+    bool importAnimals(const std::string& filename, int& loaded, int& skipped);
+    bool importFeedings(const std::string& filename, int& loaded, int& skipped);
+
+    bool saveSnapshot(const std::string& filename);
+    bool loadSnapshot(const std::string& filename);
+
+    void resizeAnimalTable(int initialSize);
+    void clear();
+    void clearFeedings();
+    void rebuild();
+
+private:
+    // Арены объявлены раньше деревьев, чтобы пережить их
+    MonotonicArena animalIndexArena;
+    MonotonicArena feedingIndexArena;
+
+    SlotMap<Animal> animals;
+    SlotMap<FeedingEntry> feedings;
+    AnimalHashTable animalTable;
+    FeedingTree feedingTree;
+    QuantityFiltersTree quantityTree;
+    DateFiltersTree dateTree;
+    SpeciesFiltersTree speciesTree;
+
+    void clearFeedingIndexes();
+    void rebuildIndexTrees();
+    // Только дерево видов / только деревья кормлений
+    void rebuildSpeciesIndex();
+    void rebuildFeedingIndexes();
+    // Поиск по кличке из пула: сравнение по id без чтения текста
+    int findAnimalInterned(InternedString nickname) const;
+    void indexFeeding(int id);
+    void unindexFeeding(int id);
+};
+
+#endif // ZOO_CATALOG_H
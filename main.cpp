@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <GLFW/glfw3.h>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <fstream>
 #include <iomanip>
@@ -13,6 +14,9 @@
 #include "FeedingTree.h"
 #include "CircularList.h"
 #include "FiltersTree.h"
+#include "StringPool.h"
+#include "ZooCatalog.h"
+#include "DateUtils.h"
 
 // --- Глобальные настройки ---
 
@@ -97,31 +101,6 @@ void SectionHeader(const char* title) {
     ImGui::Spacing();
 }
 
-// Проверка уникальности клички
-bool isNicknameUnique(const std::string& nickname, const DynamicArray<Animal>& animals) {
-    for (size_t i = 0; i < animals.size(); ++i) {
-        if (animals[i].nickname == nickname) {
-            return false;
-        }
-    }
-    return true;
-}
-
-// Проверка даты в формате DD.MM.YYYY
-bool isValidDate(const std::string& date) {
-    if (date.length() != 10) return false;
-    if (date[2] != '.' || date[5] != '.') return false;
-    try {
-        int day = std::stoi(date.substr(0, 2));
-        int month = std::stoi(date.substr(3, 2));
-        int year = std::stoi(date.substr(6, 4));
-        if (day < 1 || day > 31 || month < 1 || month > 12 || year < 1900 || year > 2100) return false;
-    } catch (...) {
-        return false;
-    }
-    return true;
-}
-
 // --- Основная функция ---
 
 int main(int, char**)
@@ -179,41 +158,29 @@ int main(int, char**)
     // ------------------------------
     // ОБЩИЕ Данные и структуры "Зоопарка"
     // ------------------------------
-    DynamicArray<Animal> animals;
-    DynamicArray<FeedingEntry> feedings;
-    AnimalHashTable animalTable(16);
-    FeedingTree feedingTree;
-
-    QuantityFiltersTree quantityTree;
-    DateFiltersTree dateTree;
-    FiltersTree<std::string> speciesTree;
+    // Все изменения идут через каталог, он же поддерживает индексы
+    ZooCatalog catalog;
+    const SlotMap<Animal>& animals = catalog.getAnimals();
+    const SlotMap<FeedingEntry>& feedings = catalog.getFeedings();
+    const AnimalHashTable& animalTable = catalog.getAnimalTable();
+    const FeedingTree& feedingTree = catalog.getFeedingTree();
+    const QuantityFiltersTree& quantityTree = catalog.getQuantityTree();
+    const DateFiltersTree& dateTree = catalog.getDateTree();
+    const SpeciesFiltersTree& speciesTree = catalog.getSpeciesTree();
 
     struct ReportResult { 
-        std::string nickname; 
-        std::string species; 
+        int32_t date;
+        InternedString nickname; 
+        InternedString species; 
         int feedingCount; 
     };
     DynamicArray<ReportResult> reportResults;
     bool reportGenerated = false;
 
-    auto rebuildAllStructures = [&]() {
-        animalTable.clear();
-        for (int i = 0; i < (int)animals.size(); ++i) animalTable.insert(animals[i].nickname, i);
-        speciesTree.clear();
-        for (int i = 0; i < (int)animals.size(); ++i) speciesTree.add(animals[i].species, i);
-        feedingTree.clear();
-        quantityTree.clear();
-        dateTree.clear();
-        for (int i = 0; i < (int)feedings.size(); ++i) {
-            feedingTree.add(feedings[i].nickname, i);
-            quantityTree.add(feedings[i].quantity, i);
-            dateTree.add(feedings[i].date, i);
-        }
-    };
-
     // --- ОБЩИЕ Переменные состояния UI ---
     char animalsFile[256] = "../Lists/animals.txt";
     char feedingsFile[256] = "../Lists/feedings.txt";
+    char snapshotFile[256] = "../Lists/zoo.snapshot";
     int initialTableSize = 16;
 
     char newNickname[128] = "";
@@ -224,7 +191,9 @@ int main(int, char**)
     int feedingQuantity = 1;
     char feedingDate[64] = "";
 
-    char reportDate[64] = "15.01.2024";
+    // Период отчета; пустая дата "по" - отчет за один день
+    char reportDateFrom[64] = "15.01.2024";
+    char reportDateTo[64] = "";
     char reportSpeciesFilter[128] = "";
     int reportQuantity = 0;
 
@@ -232,6 +201,12 @@ int main(int, char**)
     std::string statusMessage = "Добро пожаловать в систему управления зоопарком!";
     float statusMessageTime = 0.0f;
 
+    // Быстрый старт: снимок отображается в память, хеш-таблица берётся из него готовой
+    if (catalog.loadSnapshot(snapshotFile)) {
+        statusMessage = "Загружен снимок " + std::string(snapshotFile) + ": животных " +
+                        std::to_string(animals.size()) + ", кормлений " + std::to_string(feedings.size()) + ".";
+    }
+
     // ------------------------------
     // Главный цикл рендеринга
     // ------------------------------
@@ -258,27 +233,9 @@ int main(int, char**)
             ImGui::SetNextWindowSize(ImVec2((float)win_w, (float)win_h - 30));
             if (ImGui::Begin("Animal Management", nullptr, ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoBringToFrontOnFocus)) {
                 if (ImGui::Button(" Загрузить Животных")) {
-                    std::ifstream file(animalsFile);
-                    if (file.is_open()) {
-                        int loadedCount = 0;
-                        int skippedCount = 0;
-                        std::string line;
-                        while (std::getline(file, line)) {
-                            std::istringstream iss(line);
-                            std::string nickname, species, cage;
-                            if (iss >> nickname >> species >> cage) {
-                                if (isNicknameUnique(nickname, animals)) {
-                                    animals.push_back(Animal(nickname, species, cage));
-                                    loadedCount++;
-                                } else {
-                                    skippedCount++;
-                                }
-                            }
-                        }
-                        file.close();
-                        if (loadedCount > 0) {
-                            rebuildAllStructures();
-                        }
+                    int loadedCount = 0;
+                    int skippedCount = 0;
+                    if (catalog.importAnimals(animalsFile, loadedCount, skippedCount)) {
                         statusMessage = "Добавлено новых животных: " + std::to_string(loadedCount) +
                                         ". Пропущено дубликатов: " + std::to_string(skippedCount) + ".";
                     } else {
@@ -288,18 +245,32 @@ int main(int, char**)
                 }
                 ImGui::SameLine();
                 if (ImGui::Button(" Сохранить Животных")) {
-                    if (animalTable.exportToFile(animalsFile, animals)) { statusMessage = "Животные сохранены в " + std::string(animalsFile); }
+                    if (animalTable.exportToFile(animalsFile, animals.denseValues())) { statusMessage = "Животные сохранены в " + std::string(animalsFile); }
                     else { statusMessage = "Ошибка сохранения файла " + std::string(animalsFile); }
                     statusMessageTime = ImGui::GetTime();
                 }
                 ImGui::SameLine();
                 if (ImGui::Button(" Очистить ХТ")) {
-                    animals.clear();
-                    feedings.clear();
-                    rebuildAllStructures();
+                    catalog.clear();
                     statusMessage = "Справочник животных, кормлений и все структуры данных очищены.";
                     statusMessageTime = ImGui::GetTime();
                 }
+                ImGui::SameLine();
+                if (ImGui::Button(" Сохранить Снимок")) {
+                    if (catalog.saveSnapshot(snapshotFile)) { statusMessage = "Снимок сохранен в " + std::string(snapshotFile); }
+                    else { statusMessage = "Ошибка сохранения снимка " + std::string(snapshotFile); }
+                    statusMessageTime = ImGui::GetTime();
+                }
+                ImGui::SameLine();
+                if (ImGui::Button(" Загрузить Снимок")) {
+                    if (catalog.loadSnapshot(snapshotFile)) {
+                        statusMessage = "Снимок загружен: животных " + std::to_string(animals.size()) +
+                                        ", кормлений " + std::to_string(feedings.size()) + ".";
+                    } else {
+                        statusMessage = "Ошибка загрузки снимка " + std::string(snapshotFile);
+                    }
+                    statusMessageTime = ImGui::GetTime();
+                }
                 ImGui::SameLine(ImGui::GetWindowWidth() - 120);
                 if (ImGui::Button("О Программе")) {
                     statusMessage = "Курсовая работа: Зоопарк; Структуры данных: Хеш-таблица, АВЛ-дерево, Двусвязный кольцевой список";
@@ -322,13 +293,9 @@ int main(int, char**)
                                 statusMessage = "Ошибка: Вид животного не может быть пустым.";
                             } else if (strlen(newCage) == 0) {
                                 statusMessage = "Ошибка: Вольер не может быть пустым.";
-                            } else if (!isNicknameUnique(newNickname, animals)) {
+                            } else if (catalog.addAnimal(Animal(newNickname, newSpecies, newCage)) < 0) {
                                 statusMessage = "Ошибка: Животное с кличкой '" + std::string(newNickname) + "' уже существует!";
                             } else {
-                                Animal a(newNickname, newSpecies, newCage);
-                                animals.push_back(a);
-                                animalTable.insert(a.nickname, animals.size() - 1);
-                                speciesTree.add(a.species, animals.size() - 1);
                                 statusMessage = "Животное '" + std::string(newNickname) + "' добавлено.";
                                 newNickname[0] = '\0'; newSpecies[0] = '\0'; newCage[0] = '\0';
                             }
@@ -343,20 +310,11 @@ int main(int, char**)
                             } else if (strlen(newCage) == 0) {
                                 statusMessage = "Ошибка: Укажите вольер для удаления.";
                             } else {
-                                int steps;
-                                int idx = animalTable.search(newNickname, steps);
-                                if (idx >= 0 && animals[idx].species == newSpecies && animals[idx].cage == newCage) {
-                                    std::string removedNickname = animals[idx].nickname;
-                                    animals.erase(idx);
-                                    DynamicArray<FeedingEntry> new_feedings;
-                                    for(size_t i = 0; i < feedings.size(); ++i) {
-                                        if (feedings[i].nickname != removedNickname) {
-                                            new_feedings.push_back(feedings[i]);
-                                        }
-                                    }
-                                    feedings = std::move(new_feedings);
-                                    rebuildAllStructures();
-                                    statusMessage = "Животное '" + removedNickname + "' и все его кормления удалены.";
+                                int idx = catalog.findAnimal(newNickname);
+                                if (idx >= 0 && animals.get(idx).species == newSpecies && animals.get(idx).cage == newCage) {
+                                    InternedString removedNickname = animals.get(idx).nickname;
+                                    catalog.removeAnimal(idx);
+                                    statusMessage = "Животное '" + removedNickname.str() + "' и все его кормления удалены.";
                                 } else {
                                     statusMessage = "Ошибка: Животное с такими данными для удаления не найдено.";
                                 }
@@ -375,8 +333,8 @@ int main(int, char**)
                                 int idx = animalTable.search(searchNickname, steps);
                                 if (idx >= 0) {
                                     statusMessage = "Найдено за " + std::to_string(steps) + " шагов: " +
-                                                    animals[idx].nickname + " (Вид: " + animals[idx].species +
-                                                    ", Вольер: " + animals[idx].cage + ")";
+                                                    animals.get(idx).nickname.str() + " (Вид: " + animals.get(idx).species.str() +
+                                                    ", Вольер: " + animals.get(idx).cage.str() + ")";
                                 } else {
                                     statusMessage = "Животное с кличкой '" + std::string(searchNickname) + "' не найдено.";
                                 }
@@ -392,9 +350,9 @@ int main(int, char**)
                             ImGui::TableHeadersRow();
                             for (size_t i = 0; i < animals.size(); ++i) {
                                 ImGui::TableNextRow();
-                                ImGui::TableNextColumn(); ImGui::Text("%s", animals[i].nickname.c_str());
-                                ImGui::TableNextColumn(); ImGui::Text("%s", animals[i].species.c_str());
-                                ImGui::TableNextColumn(); ImGui::Text("%s", animals[i].cage.c_str());
+                                ImGui::TableNextColumn(); ImGui::Text("%s", animals.valueAt(i).nickname.c_str());
+                                ImGui::TableNextColumn(); ImGui::Text("%s", animals.valueAt(i).species.c_str());
+                                ImGui::TableNextColumn(); ImGui::Text("%s", animals.valueAt(i).cage.c_str());
                             }
                             ImGui::EndTable();
                         }
@@ -408,12 +366,14 @@ int main(int, char**)
                         ImGui::Text("Емкость: %d", animalTable.getCapacity());
                         ImGui::Text("Элементов: %d", animalTable.getSize());
                         ImGui::Text("Коэффициент загрузки: %.2f", animalTable.getLoadFactor());
+                        if (animalTable.isMigrating()) {
+                            ImGui::Text("Перехеширование: %.0f%%", animalTable.getMigrationProgress() * 100.0);
+                        }
                         ImGui::Text("Начальный размер: %d", initialTableSize);
                         ImGui::InputInt("##NewInitialSize", &initialTableSize);
                         ImGui::SameLine();
                         if(ImGui::Button("Применить")){
-                            animalTable.resize(initialTableSize);
-                            rebuildAllStructures();
+                            catalog.resizeAnimalTable(initialTableSize);
                         }
 
                         SectionHeader("Содержимое Хеш-Таблицы");
@@ -423,7 +383,7 @@ int main(int, char**)
                             ImGui::TableSetupColumn("H2 (шаг)", ImGuiTableColumnFlags_WidthFixed, 80);
                             ImGui::TableSetupColumn("Ключ (Кличка)", ImGuiTableColumnFlags_WidthStretch);
                             ImGui::TableSetupColumn("Индекс", ImGuiTableColumnFlags_WidthFixed, 60);
-                            ImGui::TableSetupColumn("Статус", ImGuiTableColumnFlags_WidthFixed, 60);
+                            ImGui::TableSetupColumn("Статус (сдвиг)", ImGuiTableColumnFlags_WidthFixed, 110);
                             ImGui::TableHeadersRow();
                             for(int i = 0; i < animalTable.getCapacity(); ++i) {
                                 HashEntry info = animalTable.getSlotInfo(i);
@@ -433,7 +393,7 @@ int main(int, char**)
 
                                 ImGui::TableNextColumn();
                                 if(info.status == 1) {
-                                    ImGui::Text("%d", animalTable.getPrimaryHash(info.key));
+                                    ImGui::Text("%d", animalTable.getPrimaryHash(info.key.view()));
                                 } else {
                                     ImGui::Text("-");
                                 }
@@ -456,9 +416,10 @@ int main(int, char**)
                                 }
 
                                 ImGui::TableNextColumn();
+                                // Удалённых (статус 2) нет: удаление сдвигает хвост пробы назад.
+                                // В скобках - расстояние Robin Hood от первичного слота
                                 if(info.status == 0) ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "0");
-                                else if(info.status == 1) ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "1");
-                                else if(info.status == 2) ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "2");
+                                else ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "1 (%d)", animalTable.getProbeDistance(i));
                             }
                             ImGui::EndTable();
                         }
@@ -514,25 +475,7 @@ int main(int, char**)
                 if (ImGui::Button(" Загрузить Кормления")) {
                     int skipped_count = 0;
                     int loaded_count = 0;
-
-                    std::ifstream file(feedingsFile);
-                    if (file.is_open()) {
-                        std::string line;
-                        while (std::getline(file, line)) {
-                            std::istringstream iss(line);
-                            FeedingEntry e;
-                            if (iss >> e.nickname >> e.feedType >> e.quantity >> e.date) {
-                                int steps;
-                                if (animalTable.search(e.nickname, steps) >= 0) {
-                                    feedings.push_back(e);
-                                    loaded_count++;
-                                } else {
-                                    skipped_count++;
-                                }
-                            }
-                        }
-                        file.close();
-                        rebuildAllStructures();
+                    if (catalog.importFeedings(feedingsFile, loaded_count, skipped_count)) {
                         statusMessage = "Добавлено кормлений: " + std::to_string(loaded_count) +
                                         " (пропущено " + std::to_string(skipped_count) + " из-за отсутствия животных).";
                     } else {
@@ -542,14 +485,13 @@ int main(int, char**)
                 }
                 ImGui::SameLine();
                 if (ImGui::Button(" Сохранить Кормления")) {
-                    if (feedingTree.exportToFile(feedingsFile, feedings)) { statusMessage = "Кормления сохранены в " + std::string(feedingsFile); }
+                    if (feedingTree.exportToFile(feedingsFile, feedings.denseValues())) { statusMessage = "Кормления сохранены в " + std::string(feedingsFile); }
                     else { statusMessage = "Ошибка сохранения файла " + std::string(feedingsFile); }
                     statusMessageTime = ImGui::GetTime();
                 }
                 ImGui::SameLine();
                 if (ImGui::Button(" Очистить Дерево")) {
-                    feedings.clear();
-                    rebuildAllStructures();
+                    catalog.clearFeedings();
                     statusMessage = "Справочник кормлений и дерево очищены.";
                     statusMessageTime = ImGui::GetTime();
                 }
@@ -589,23 +531,29 @@ int main(int, char**)
 
                             // --- Основная логика отчета ---
 
+                            const int W_DATE = 10;
                             const int W_NICKNAME = 25;
                             const int W_SPECIES = 20;
                             const int W_COUNT = 22;
 
                             // Заголовок файла
                             reportFile << "=== ОТЧЕТ О КОРМЛЕНИИ ЖИВОТНЫХ ===\n";
-                            reportFile << "Дата: " << reportDate << "\n";
+                            if (strlen(reportDateTo) > 0)
+                                reportFile << "Период: " << reportDateFrom << " - " << reportDateTo << "\n";
+                            else
+                                reportFile << "Дата: " << reportDateFrom << "\n";
                             if (strlen(reportSpeciesFilter) > 0)
                                 reportFile << "Фильтр по виду: " << reportSpeciesFilter << "\n";
                             reportFile << "\n";
 
                             // Заголовки таблицы
+                            reportFile << padRight("Дата", W_DATE) << " | ";
                             reportFile << padRight("Кличка", W_NICKNAME) << " | ";
                             reportFile << padRight("Вид", W_SPECIES) << " | ";
                             reportFile << padLeft("Количество кормлений", W_COUNT) << "\n";
 
                             // Линия-разделитель
+                            reportFile << std::string(W_DATE, '-') << "-+-";
                             reportFile << std::string(W_NICKNAME, '-') << "-+-";
                             reportFile << std::string(W_SPECIES, '-') << "-+-";
                             reportFile << std::string(W_COUNT, '-') << "\n";
@@ -616,18 +564,20 @@ int main(int, char**)
                                 const auto& result = reportResults[i];
                                 totalFeedings += result.feedingCount;
 
-                                reportFile << padRight(result.nickname, W_NICKNAME) << " | ";
-                                reportFile << padRight(result.species, W_SPECIES) << " | ";
+                                reportFile << padRight(DateUtils::formatDate(result.date), W_DATE) << " | ";
+                                reportFile << padRight(result.nickname.str(), W_NICKNAME) << " | ";
+                                reportFile << padRight(result.species.str(), W_SPECIES) << " | ";
                                 reportFile << padLeft(std::to_string(result.feedingCount), W_COUNT) << "\n";
                             }
 
                             // Линия для итогов
+                            reportFile << std::string(W_DATE, '=') << "=+=";
                             reportFile << std::string(W_NICKNAME, '=') << "=+=";
                             reportFile << std::string(W_SPECIES, '=') << "=+=";
                             reportFile << std::string(W_COUNT, '=') << "\n";
 
                             // Строка "ИТОГО"
-                            int prefixWidth = W_NICKNAME + W_SPECIES + 3;
+                            int prefixWidth = W_DATE + W_NICKNAME + W_SPECIES + 6;
                             reportFile << padRight("ИТОГО:", prefixWidth) << " | ";
                             reportFile << padLeft(std::to_string(totalFeedings), W_COUNT) << "\n";
 
@@ -658,6 +608,7 @@ int main(int, char**)
                         ImGui::InputTextWithHint("Дата", "DD.MM.YYYY", feedingDate, IM_ARRAYSIZE(feedingDate));
 
                         if (ImGui::Button("Добавить Кормление", ImVec2(ImGui::GetContentRegionAvail().x * 0.5f - 4, 0))) {
+                            int32_t feedingDay = 0;
                             if (strlen(feedingNickname) == 0) {
                                 statusMessage = "Ошибка: Кличка животного не может быть пустой.";
                             } else if (strlen(feedingFeedType) == 0) {
@@ -668,18 +619,12 @@ int main(int, char**)
                                 statusMessage = "Ошибка: Количество кормлений не может превышать 1000.";
                             } else if (strlen(feedingDate) == 0) {
                                 statusMessage = "Ошибка: Дата кормления не может быть пустой.";
-                            } else if (!isValidDate(feedingDate)) {
+                            } else if (!DateUtils::parseDate(feedingDate, feedingDay)) {
                                 statusMessage = "Ошибка: Некорректный формат даты! Требуется DD.MM.YYYY";
                             } else {
-                                int steps;
-                                if (animalTable.search(feedingNickname, steps) < 0) {
+                                if (catalog.addFeeding(FeedingEntry{feedingNickname, feedingFeedType, feedingQuantity, feedingDay}) < 0) {
                                     statusMessage = "Ошибка: Животное с кличкой '" + std::string(feedingNickname) + "' не найдено в справочнике.";
                                 } else {
-                                    FeedingEntry f{feedingNickname, feedingFeedType, feedingQuantity, feedingDate};
-                                    feedings.push_back(f);
-                                    feedingTree.add(f.nickname, feedings.size()-1);
-                                    quantityTree.add(f.quantity, feedings.size()-1);
-                                    dateTree.add(f.date, feedings.size()-1);
                                     statusMessage = "Кормление для '" + std::string(feedingNickname) + "' добавлено.";
                                 }
                             }
@@ -687,6 +632,7 @@ int main(int, char**)
                         }
                         ImGui::SameLine();
                         if (ImGui::Button("Удалить Кормление", ImVec2(-1, 0))) {
+                            int32_t feedingDay = 0;
                             if (strlen(feedingNickname) == 0) {
                                 statusMessage = "Ошибка: Укажите кличку для удаления кормления.";
                             } else if (strlen(feedingFeedType) == 0) {
@@ -695,24 +641,15 @@ int main(int, char**)
                                 statusMessage = "Ошибка: Количество не может быть отрицательным или нулевым.";
                             } else if (strlen(feedingDate) == 0) {
                                 statusMessage = "Ошибка: Укажите дату для удаления кормления.";
-                            } else if (!isValidDate(feedingDate)) {
+                            } else if (!DateUtils::parseDate(feedingDate, feedingDay)) {
                                 statusMessage = "Ошибка: Некорректный формат даты! Требуется DD.MM.YYYY";
                             } else {
-                                bool found = false;
-                                int indexToRemove = -1;
-                                for (int i = 0; i < (int)feedings.size(); ++i) {
-                                    if (feedings[i].nickname == feedingNickname &&
-                                        feedings[i].feedType == feedingFeedType &&
-                                        feedings[i].quantity == feedingQuantity &&
-                                        feedings[i].date == feedingDate) {
-                                        indexToRemove = i;
-                                        found = true;
-                                        break;
-                                        }
-                                }
-                                if (found) {
-                                    feedings.erase(indexToRemove);
-                                    rebuildAllStructures();
+                                // Только поиск в пуле: строки, которых там нет, не интернируются
+                                int indexToRemove = catalog.findFeeding(FeedingEntry{InternedString::lookup(feedingNickname),
+                                                                                     InternedString::lookup(feedingFeedType),
+                                                                                     feedingQuantity, feedingDay});
+                                if (indexToRemove >= 0) {
+                                    catalog.removeFeeding(indexToRemove);
                                     statusMessage = "Кормление удалено.";
                                 } else {
                                     statusMessage = "Ошибка: Кормление с такими данными не найдено.";
@@ -728,7 +665,7 @@ int main(int, char**)
                             if (strlen(searchFeedingNickname) == 0) {
                                 statusMessage = "Ошибка: Укажите кличку для поиска кормлений.";
                             } else {
-                                CircularList result = feedingTree.search(searchFeedingNickname);
+                                PostingsView<CircularList> result = feedingTree.search(searchFeedingNickname);
                                 if (result.size() > 0) {
                                     std::stringstream ss;
                                     ss << "Найдено кормлений: " << result.size() << " для клички '" << searchFeedingNickname << "'. ";
@@ -741,19 +678,29 @@ int main(int, char**)
                         }
 
 
-                        SectionHeader("Список Кормлений");
+                        SectionHeader("Список Кормлений (по дате)");
                          if (ImGui::BeginTable("FeedingsTable", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
                             ImGui::TableSetupColumn("Кличка", ImGuiTableColumnFlags_WidthStretch);
                             ImGui::TableSetupColumn("Тип корма", ImGuiTableColumnFlags_WidthStretch);
                              ImGui::TableSetupColumn("Кормлений", ImGuiTableColumnFlags_WidthFixed, 80);
                             ImGui::TableSetupColumn("Дата", ImGuiTableColumnFlags_WidthFixed, 120);
                             ImGui::TableHeadersRow();
-                            for (size_t i = 0; i < feedings.size(); ++i) {
-                                ImGui::TableNextRow();
-                                ImGui::TableNextColumn(); ImGui::Text("%s", feedings[i].nickname.c_str());
-                                ImGui::TableNextColumn(); ImGui::Text("%s", feedings[i].feedType.c_str());
-                                ImGui::TableNextColumn(); ImGui::Text("%d", feedings[i].quantity);
-                                ImGui::TableNextColumn(); ImGui::Text("%s", feedings[i].date.c_str());
+                            // Рисуются только видимые строки: страница берётся из дерева дат
+                            // порядковым запросом, а не обходом всех кормлений
+                            ImGuiListClipper clipper;
+                            clipper.Begin(dateTree.size());
+                            DynamicArray<int> visibleFeedings;
+                            while (clipper.Step()) {
+                                visibleFeedings.clear();
+                                dateTree.page(clipper.DisplayStart, clipper.DisplayEnd - clipper.DisplayStart, visibleFeedings);
+                                for (int feedingIndex : visibleFeedings) {
+                                    const FeedingEntry& feeding = feedings.get(feedingIndex);
+                                    ImGui::TableNextRow();
+                                    ImGui::TableNextColumn(); ImGui::Text("%s", feeding.nickname.c_str());
+                                    ImGui::TableNextColumn(); ImGui::Text("%s", feeding.feedType.c_str());
+                                    ImGui::TableNextColumn(); ImGui::Text("%d", feeding.quantity);
+                                    ImGui::TableNextColumn(); ImGui::Text("%s", DateUtils::formatDate(feeding.date).c_str());
+                                }
                             }
                             ImGui::EndTable();
                         }
@@ -764,75 +711,84 @@ int main(int, char**)
                     if (ImGui::BeginTabItem("Отчеты")) {
                         ImGui::BeginChild("Reports", ImVec2(0,0), false);
                         SectionHeader("Фильтры отчета");
-                        ImGui::InputTextWithHint("Дата", "DD.MM.YYYY", reportDate, IM_ARRAYSIZE(reportDate));
+                        ImGui::InputTextWithHint("Дата с", "DD.MM.YYYY", reportDateFrom, IM_ARRAYSIZE(reportDateFrom));
+                        ImGui::InputTextWithHint("Дата по (необязательно)", "DD.MM.YYYY", reportDateTo, IM_ARRAYSIZE(reportDateTo));
                         ImGui::InputTextWithHint("Фильтр по виду (необязательно)", "Например, 'Тигр'", reportSpeciesFilter, IM_ARRAYSIZE(reportSpeciesFilter));
                         ImGui::InputInt("Фильтр: Кол-во кормлений (0 = любое)", &reportQuantity);
 
                         if (ImGui::Button("Сформировать отчет", ImVec2(-1, 0))) {
                             reportResults.clear();
-                            if (strlen(reportDate) == 0) {
+                            int32_t dayFrom = 0;
+                            int32_t dayTo = 0;
+                            if (strlen(reportDateFrom) == 0) {
                                 statusMessage = "Ошибка: Дата не может быть пустой для формирования отчета.";
-                            } else if (!isValidDate(reportDate)) {
+                            } else if (!DateUtils::parseDate(reportDateFrom, dayFrom) ||
+                                       (strlen(reportDateTo) > 0 && !DateUtils::parseDate(reportDateTo, dayTo))) {
                                 statusMessage = "Ошибка: Некорректный формат даты! Требуется DD.MM.YYYY";
+                            } else if (strlen(reportDateTo) > 0 && dayTo < dayFrom) {
+                                statusMessage = "Ошибка: Конец периода раньше его начала.";
                             } else if (reportQuantity < 0) {
                                 statusMessage = "Ошибка: Количество не может быть отрицательным.";
                             } else {
-
-                                // Шаг 1: Получаем базовый список по обязательной дате
-                                CircularList finalIndices = dateTree.search(reportDate);
-
-                                // Шаг 2: Фильтруем по виду, если он указан
-                                if (strlen(reportSpeciesFilter) > 0) {
-                                    CircularList tempList;
-                                    for (int i = 0; i < finalIndices.size(); ++i) {
-                                        int feedingIndex = finalIndices.get(i);
-                                        const auto& feeding = feedings[feedingIndex];
-                                        int steps;
-                                        int animalIdx = animalTable.search(feeding.nickname, steps);
-                                        if (animalIdx != -1 && animals[animalIdx].species == reportSpeciesFilter) {
-                                            tempList.add(feedingIndex);
-                                        }
+                                if (strlen(reportDateTo) == 0) dayTo = dayFrom;
+
+                                // Шаг 1: Получаем кормления за период - обход диапазона дерева дат.
+                                // За один день с фильтром по количеству - пересечение списков индексов
+                                DynamicArray<int> rows;
+                                if (dayFrom == dayTo && reportQuantity > 0) {
+                                    const PostingList* dateIndices = dateTree.findPostings(dayFrom);
+                                    const PostingList* quantityIndices = quantityTree.findPostings(reportQuantity);
+                                    if (dateIndices && quantityIndices) {
+                                        PostingList::intersect(*dateIndices, *quantityIndices, rows);
                                     }
-                                    finalIndices = tempList;
-                                }
-
-                                // Шаг 3: Фильтруем по количеству, если оно указано
-                                if (reportQuantity > 0) {
-                                    CircularList tempList;
-                                    for (int i = 0; i < finalIndices.size(); ++i) {
-                                        int feedingIndex = finalIndices.get(i);
-                                        if (feedings[feedingIndex].quantity == reportQuantity) {
-                                            tempList.add(feedingIndex);
-                                        }
+                                } else {
+                                    PostingsView<PostingList> periodIndices = dateTree.searchInRange(dayFrom, dayTo);
+                                    rows.reserve(periodIndices.size());
+                                    for (int feedingIndex : periodIndices) {
+                                        rows.push_back(feedingIndex);
                                     }
-                                    finalIndices = tempList;
+                                }
+                                DynamicArray<std::string_view> rowNicknames;
+                                rowNicknames.reserve(rows.size());
+                                for (int feedingIndex : rows) {
+                                    rowNicknames.push_back(feedings.get(feedingIndex).nickname.view());
                                 }
 
-                                // --- Формирование отчета: каждое кормление - отдельная строка ---
-
-                                int totalFeedingsSum = 0;
-
-                                for(int i = 0; i < finalIndices.size(); ++i) {
-                                    int index = finalIndices.get(i);
-                                    if(index == -1) continue;
-                                    const auto& feeding = feedings[index];
-                                    int steps;
-                                    int animalIdx = animalTable.search(feeding.nickname, steps);
-
-                                    if (animalIdx != -1) {
-                                        const auto& animal = animals[animalIdx];
-
-                                        // Добавляем запись в отчет
-                                        reportResults.push_back({
-                                            feeding.nickname,
-                                            animal.species,
-                                            feeding.quantity
-                                        });
+                                // Шаг 2: Находим животных всех строк одним пакетным поиском
+                                DynamicArray<int> rowAnimals;
+                                for (size_t i = 0; i < rows.size(); ++i) rowAnimals.push_back(-1);
+                                if (!rows.empty()) {
+                                    animalTable.searchBatch(&rowNicknames[0], rows.size(), &rowAnimals[0]);
+                                }
 
-                                        // Суммируем количество кормлений
-                                        totalFeedingsSum += feeding.quantity;
-                                    }
+                                // Шаг 3: Фильтруем по виду и количеству, если они указаны.
+                                // Каждое кормление - отдельная строка отчета
+                                std::string_view speciesFilter(reportSpeciesFilter);
+                                bool filtered = !speciesFilter.empty() || reportQuantity > 0;
+                                long long totalFeedingsSum = 0;
+
+                                for (size_t i = 0; i < rows.size(); ++i) {
+                                    int animalIdx = rowAnimals[i];
+                                    if (animalIdx == -1) continue;
+                                    const auto& feeding = feedings.get(rows[i]);
+                                    const auto& animal = animals.get(animalIdx);
+
+                                    if (!speciesFilter.empty() && animal.species != speciesFilter) continue;
+                                    if (reportQuantity > 0 && feeding.quantity != reportQuantity) continue;
+
+                                    // Добавляем запись в отчет
+                                    reportResults.push_back({
+                                        feeding.date,
+                                        feeding.nickname,
+                                        animal.species,
+                                        feeding.quantity
+                                    });
+
+                                    // Суммируем количество кормлений
+                                    if (filtered) totalFeedingsSum += feeding.quantity;
                                 }
+                                // Без фильтров итог за период берётся из агрегатов дерева дат за O(log n)
+                                if (!filtered) totalFeedingsSum = dateTree.sumInRange(dayFrom, dayTo);
 
                                 reportGenerated = true;
                                 statusMessage = "Отчет сформирован: найдено животных: " +
@@ -844,17 +800,23 @@ int main(int, char**)
                         }
 
                         SectionHeader("Результаты отчета");
-                        if (ImGui::BeginTable("ReportTable", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+                        if (ImGui::BeginTable("ReportTable", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+                            ImGui::TableSetupColumn("Дата", ImGuiTableColumnFlags_WidthFixed, 120);
                             ImGui::TableSetupColumn("Кличка", ImGuiTableColumnFlags_WidthStretch);
                             ImGui::TableSetupColumn("Вид", ImGuiTableColumnFlags_WidthStretch);
                             ImGui::TableSetupColumn("Количество кормлений", ImGuiTableColumnFlags_WidthFixed, 200);
                             ImGui::TableHeadersRow();
                             if(reportGenerated) {
-                                for(size_t i = 0; i < reportResults.size(); ++i) {
-                                    ImGui::TableNextRow();
-                                    ImGui::TableNextColumn(); ImGui::Text("%s", reportResults[i].nickname.c_str());
-                                    ImGui::TableNextColumn(); ImGui::Text("%s", reportResults[i].species.c_str());
-                                    ImGui::TableNextColumn(); ImGui::Text("%d", reportResults[i].feedingCount);
+                                ImGuiListClipper clipper;
+                                clipper.Begin(static_cast<int>(reportResults.size()));
+                                while (clipper.Step()) {
+                                    for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                                        ImGui::TableNextRow();
+                                        ImGui::TableNextColumn(); ImGui::Text("%s", DateUtils::formatDate(reportResults[i].date).c_str());
+                                        ImGui::TableNextColumn(); ImGui::Text("%s", reportResults[i].nickname.c_str());
+                                        ImGui::TableNextColumn(); ImGui::Text("%s", reportResults[i].species.c_str());
+                                        ImGui::TableNextColumn(); ImGui::Text("%d", reportResults[i].feedingCount);
+                                    }
                                 }
                             }
                             ImGui::EndTable();
@@ -873,7 +835,7 @@ int main(int, char**)
                         }
                         if (ImGui::Button("Показать Дерево Фильтра по Дате", ImVec2(-1, 0))) {
                             debugLog << "\n--- Дерево фильтра по дате ---\n";
-                            dateTree.print(debugLog);
+                            dateTree.print(debugLog, DateUtils::formatDate);
                             debugLog << "--------------------------------\n\n";
                         }
                         if (ImGui::Button("Показать Дерево Фильтра по Виду", ImVec2(-1, 0))) {
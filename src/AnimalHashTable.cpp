@@ -1,210 +1,647 @@
 #include "AnimalHashTable.h"
+#include "TextLoader.h"
 #include <fstream>
-#include <sstream>
 #include <iomanip>
-
-AnimalHashTable::AnimalHashTable(int initialSize)
-    : capacity(initialSize), size(0), initialCapacity(initialSize) {
-    table = new HashEntry[capacity];
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANIMAL_HASH_TABLE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+AnimalHashTable::AnimalHashTable(int initialSize, uint64_t seed)
+    : migrateCursor(0), size(0), initialCapacity(roundUpPow2(initialSize)), seed(seed),
+      maxLoadFactor(LOAD_FACTOR_MAX), incrementalRehash(true) {
+    table = allocateSlots(initialCapacity);
+    oldTable = Slots{nullptr, nullptr, nullptr, nullptr, 0};
 }
 
 AnimalHashTable::~AnimalHashTable() {
-    delete[] table;
+    releaseSlots(table);
+    releaseSlots(oldTable);
 }
 
-int AnimalHashTable::primaryHash(const std::string& key) const {
-    unsigned long hash = 0;
-    for (size_t i = 0; i < key.length(); i += 4) {
-        unsigned int chunk = 0;
-        for (size_t j = i; j < i + 4 && j < key.length(); ++j) {
-            chunk = (chunk << 8) + static_cast<unsigned char>(key[j]);
-        }
-        hash += chunk;
+int AnimalHashTable::roundUpPow2(int n) {
+    int result = GROUP_WIDTH;
+    while (result < n) {
+        result <<= 1;
     }
-    return hash % capacity;
+    return result;
 }
 
-int AnimalHashTable::getStepSize() const {
-    return 3;
+// --- Сканирование группы из GROUP_WIDTH управляющих байтов ---
+
+static uint32_t matchByte(const uint8_t* group, uint8_t value) {
+#ifdef ANIMAL_HASH_TABLE_SSE2
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    __m128i match = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(value)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(match));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < AnimalHashTable::GROUP_WIDTH; ++i) {
+        if (group[i] == value) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+static int lowestBit(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long bit;
+    _BitScanForward(&bit, mask);
+    return static_cast<int>(bit);
+#else
+    return __builtin_ctz(mask);
+#endif
 }
 
-int AnimalHashTable::findSlot(const std::string& key, bool forInsertion) const {
-    int index = primaryHash(key);
-    int step = getStepSize();
-    int deletedSlot = -1;
+static void prefetch(const void* address) {
+#ifdef ANIMAL_HASH_TABLE_SSE2
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#elif defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
 
-    for (int i = 0; i < capacity; ++i) {
-        if (table[index].status == 0) {
-            return forInsertion && deletedSlot != -1 ? deletedSlot : index;
-        }
-        else if (table[index].status == 1) {
-            if (table[index].key == key) {
-                return index;
+AnimalHashTable::Slots AnimalHashTable::allocateSlots(int slotCount) {
+    Slots slots;
+    // Хвост из GROUP_WIDTH - 1 байтов дублирует начало, чтобы группу можно было
+    // читать с любого слота без проверки на переход через конец таблицы
+    slots.ctrl = new uint8_t[slotCount + GROUP_WIDTH - 1];
+    std::memset(slots.ctrl, CTRL_EMPTY, slotCount + GROUP_WIDTH - 1);
+    slots.keys = new uint32_t[slotCount];
+    slots.indices = new int[slotCount];
+    slots.hashes = new uint64_t[slotCount];
+    slots.capacity = slotCount;
+    return slots;
+}
+
+void AnimalHashTable::releaseSlots(Slots& slots) {
+    delete[] slots.ctrl;
+    delete[] slots.keys;
+    delete[] slots.indices;
+    delete[] slots.hashes;
+    slots = Slots{nullptr, nullptr, nullptr, nullptr, 0};
+}
+
+void AnimalHashTable::setCtrl(Slots& slots, int slot, uint8_t value) {
+    slots.ctrl[slot] = value;
+    if (slot < GROUP_WIDTH - 1) {
+        slots.ctrl[slots.capacity + slot] = value;
+    }
+}
+
+int AnimalHashTable::getStepSize() const {
+    return 1;
+}
+
+int AnimalHashTable::findSlot(const Slots& slots, std::string_view key, uint64_t hash, int* steps) {
+    // Ключ задан текстом: совпадение фрагмента проверяется сравнением строк,
+    // полный хеш слота не читается
+    int mask = slots.capacity - 1;
+    int pos = slotFor(slots, hash);
+    uint8_t fragment = fragmentOf(hash);
+
+    for (int probed = 0; probed < slots.capacity; probed += GROUP_WIDTH) {
+        if (steps) (*steps)++;
+        const uint8_t* group = slots.ctrl + pos;
+
+        uint32_t candidates = matchByte(group, fragment);
+        while (candidates) {
+            int slot = (pos + lowestBit(candidates)) & mask;
+            if (StringPool::global().view(slots.keys[slot]) == key) {
+                return slot;
             }
+            candidates &= candidates - 1;
         }
-        else if (table[index].status == 2) {
-            if (forInsertion && deletedSlot == -1) {
-                deletedSlot = index;
-            }
+        if (matchByte(group, CTRL_EMPTY)) {
+            return -1;
         }
 
-        index = (index + step) % capacity;
+        pos = (pos + GROUP_WIDTH) & mask;
     }
 
-    return forInsertion ? deletedSlot : -1;
+    return -1;
 }
 
-bool AnimalHashTable::insert(const std::string& nickname, int index) {
-    if (static_cast<double>(size + 1) / capacity > LOAD_FACTOR_MAX) {
-        rehash(capacity * 2);
+int AnimalHashTable::findSlot(const Slots& slots, InternedString key, uint64_t hash, int* steps) {
+    // Равные строки в пуле имеют один id, поэтому хватает сравнения keys[slot]
+    int mask = slots.capacity - 1;
+    int pos = slotFor(slots, hash);
+    uint8_t fragment = fragmentOf(hash);
+    uint32_t keyId = key.getId();
+
+    for (int probed = 0; probed < slots.capacity; probed += GROUP_WIDTH) {
+        if (steps) (*steps)++;
+        const uint8_t* group = slots.ctrl + pos;
+
+        uint32_t candidates = matchByte(group, fragment);
+        while (candidates) {
+            int slot = (pos + lowestBit(candidates)) & mask;
+            if (slots.keys[slot] == keyId) {
+                return slot;
+            }
+            candidates &= candidates - 1;
+        }
+        if (matchByte(group, CTRL_EMPTY)) {
+            return -1;
+        }
+
+        pos = (pos + GROUP_WIDTH) & mask;
     }
 
-    int slot = findSlot(nickname, true);
-    if (slot == -1) {
-        return false;
+    return -1;
+}
+
+bool AnimalHashTable::insert(InternedString nickname, int index) {
+    if (isMigrating()) {
+        migrate(MIGRATION_STEP);
     }
 
-    if (table[slot].status == 1 && table[slot].key == nickname) {
-        table[slot].index = index;
+    uint64_t hash = hashInterned(nickname);
+    int slot = findSlot(table, nickname, hash);
+    if (slot != -1) {
+        table.indices[slot] = index;
         return true;
     }
+    if (isMigrating()) {
+        slot = findSlot(oldTable, nickname, hash);
+        if (slot != -1) {
+            oldTable.indices[slot] = index;
+            return true;
+        }
+    }
 
-    table[slot].key = nickname;
-    table[slot].index = index;
-    table[slot].status = 1;
-    size++;
+    if (static_cast<double>(size + 1) / table.capacity > maxLoadFactor) {
+        rehash(table.capacity * 2);
+    }
 
+    insertHashed(table, nickname.getId(), index, hash);
+    size++;
     return true;
 }
 
-bool AnimalHashTable::remove(const std::string& nickname) {
-    int slot = findSlot(nickname, false);
-    if (slot == -1 || table[slot].status != 1) {
-        return false;
+void AnimalHashTable::insertHashed(Slots& slots, uint32_t keyId, int index, uint64_t hash) {
+    // Robin Hood: запись, ушедшая от своего слота дальше текущей, занимает её место,
+    // а вытесненная продолжает поиск. Дубликаты вызывающий код уже исключил.
+    int mask = slots.capacity - 1;
+    int slot = slotFor(slots, hash);
+    int distance = 0;
+
+    while (slots.ctrl[slot] != CTRL_EMPTY) {
+        int existingDistance = probeDistance(slots, slot);
+        if (existingDistance < distance) {
+            std::swap(keyId, slots.keys[slot]);
+            std::swap(index, slots.indices[slot]);
+            std::swap(hash, slots.hashes[slot]);
+            setCtrl(slots, slot, fragmentOf(slots.hashes[slot]));
+            distance = existingDistance;
+        }
+        slot = (slot + 1) & mask;
+        distance++;
     }
 
-    table[slot].status = 2;
+    slots.keys[slot] = keyId;
+    slots.indices[slot] = index;
+    slots.hashes[slot] = hash;
+    setCtrl(slots, slot, fragmentOf(hash));
+}
+
+void AnimalHashTable::eraseSlot(Slots& slots, int slot) {
+    // Обратный сдвиг: следующие записи кластера, стоящие не на своём месте,
+    // сдвигаются на шаг назад, поэтому надгробия не нужны
+    int mask = slots.capacity - 1;
+    int next = (slot + 1) & mask;
+
+    while (slots.ctrl[next] != CTRL_EMPTY && probeDistance(slots, next) > 0) {
+        slots.keys[slot] = slots.keys[next];
+        slots.indices[slot] = slots.indices[next];
+        slots.hashes[slot] = slots.hashes[next];
+        setCtrl(slots, slot, slots.ctrl[next]);
+        slot = next;
+        next = (next + 1) & mask;
+    }
+
+    setCtrl(slots, slot, CTRL_EMPTY);
+}
+
+bool AnimalHashTable::remove(std::string_view nickname) {
+    return removeHashed(nickname, hashKey(nickname, seed));
+}
+
+bool AnimalHashTable::removeInterned(InternedString nickname) {
+    return removeHashed(nickname, hashInterned(nickname));
+}
+
+template <typename Key>
+bool AnimalHashTable::removeHashed(Key nickname, uint64_t hash) {
+    if (isMigrating()) {
+        migrate(MIGRATION_STEP);
+    }
+
+    int slot = findSlot(table, nickname, hash);
+    if (slot != -1) {
+        eraseSlot(table, slot);
+    } else if (isMigrating() && (slot = findSlot(oldTable, nickname, hash)) != -1) {
+        // В старой таблице записи не сдвигаются, чтобы не нарушить ещё не перенесённые цепочки
+        setCtrl(oldTable, slot, CTRL_MOVED);
+    } else {
+        return false;
+    }
     size--;
 
-    if (capacity > initialCapacity &&
-        static_cast<double>(size) / capacity < LOAD_FACTOR_MIN) {
-        int newCapacity = (capacity / 2 > initialCapacity) ? (capacity / 2) : initialCapacity;
+    if (!isMigrating() && table.capacity > initialCapacity &&
+        static_cast<double>(size) / table.capacity < LOAD_FACTOR_MIN) {
+        int newCapacity = (table.capacity / 2 > initialCapacity) ? (table.capacity / 2) : initialCapacity;
         rehash(newCapacity);
     }
 
     return true;
 }
 
-int AnimalHashTable::search(const std::string& nickname, int& steps) const {
-    int index = primaryHash(nickname);
-    int step = getStepSize();
+template <typename Key>
+int AnimalHashTable::findIndex(Key key, uint64_t hash, int& steps) const {
+    int slot = findSlot(table, key, hash, &steps);
+    if (slot != -1) {
+        return table.indices[slot];
+    }
+    if (isMigrating()) {
+        slot = findSlot(oldTable, key, hash, &steps);
+        if (slot != -1) {
+            return oldTable.indices[slot];
+        }
+    }
+    return -1;
+}
+
+int AnimalHashTable::search(std::string_view nickname, int& steps) const {
+    if (isMigrating()) {
+        migrate(MIGRATION_STEP);
+    }
     steps = 0;
+    return findIndex(nickname, hashKey(nickname, seed), steps);
+}
 
-    for (int i = 0; i < capacity; ++i) {
-        steps++;
+int AnimalHashTable::searchConcurrent(std::string_view nickname, int& steps) const {
+    steps = 0;
+    return findIndex(nickname, hashKey(nickname, seed), steps);
+}
 
-        if (table[index].status == 0) {
-            return -1;
+int AnimalHashTable::searchInterned(InternedString nickname, int& steps) const {
+    if (isMigrating()) {
+        migrate(MIGRATION_STEP);
+    }
+    steps = 0;
+    return findIndex(nickname, hashInterned(nickname), steps);
+}
+
+void AnimalHashTable::searchBatch(const std::string_view* nicknames, size_t count,
+                                  int* outIndices, int* outSteps) const {
+    uint64_t hashes[BATCH_WIDTH];
+    if (isMigrating()) {
+        migrate(MIGRATION_STEP);
+    }
+
+    for (size_t base = 0; base < count; base += BATCH_WIDTH) {
+        size_t batch = count - base < BATCH_WIDTH ? count - base : BATCH_WIDTH;
+
+        for (size_t i = 0; i < batch; ++i) {
+            hashes[i] = hashKey(nicknames[base + i], seed);
+            int slot = slotFor(table, hashes[i]);
+            prefetch(table.ctrl + slot);
+            prefetch(table.keys + slot);
         }
-        if (table[index].status == 1 && table[index].key == nickname) {
-            return table[index].index;
+
+        for (size_t i = 0; i < batch; ++i) {
+            int steps = 0;
+            outIndices[base + i] = findIndex(nicknames[base + i], hashes[i], steps);
+            if (outSteps) outSteps[base + i] = steps;
         }
+    }
+}
 
-        index = (index + step) % capacity;
+HashEntry AnimalHashTable::getSlotInfo(int slotIndex) const {
+    HashEntry entry;
+    if (slotIndex < 0 || slotIndex >= table.capacity || table.ctrl[slotIndex] == CTRL_EMPTY) {
+        return entry;
     }
+    entry.key = InternedString::fromId(table.keys[slotIndex]);
+    entry.index = table.indices[slotIndex];
+    entry.hash = table.hashes[slotIndex];
+    entry.status = 1;
+    return entry;
+}
 
-    return -1;
+int AnimalHashTable::getProbeDistance(int slotIndex) const {
+    if (slotIndex < 0 || slotIndex >= table.capacity || table.ctrl[slotIndex] == CTRL_EMPTY) {
+        return -1;
+    }
+    return probeDistance(table, slotIndex);
 }
 
 void AnimalHashTable::clear() {
-    delete[] table;
-    capacity = initialCapacity;
+    releaseSlots(table);
+    releaseSlots(oldTable);
+    migrateCursor = 0;
     size = 0;
-    table = new HashEntry[capacity];
+    table = allocateSlots(initialCapacity);
 }
 
 void AnimalHashTable::resize(int newInitialSize) {
-    delete[] table;
-    capacity = newInitialSize;
-    initialCapacity = newInitialSize;
+    initialCapacity = roundUpPow2(newInitialSize);
+    clear();
+}
+
+void AnimalHashTable::build(const DynamicArray<Animal>& animals) {
+    buildFrom(animals, nullptr);
+}
+
+void AnimalHashTable::build(const SlotMap<Animal>& animals) {
+    buildFrom(animals.denseValues(), &animals.denseIds());
+}
+
+void AnimalHashTable::buildFrom(const DynamicArray<Animal>& animals, const DynamicArray<int>* ids) {
+    // Ёмкость выбирается сразу под итоговое число записей с учётом maxLoadFactor,
+    // поэтому промежуточных перехеширований нет
+    int count = static_cast<int>(animals.size());
+    int required = static_cast<int>(count / maxLoadFactor) + 1;
+
+    releaseSlots(table);
+    releaseSlots(oldTable);
+    migrateCursor = 0;
     size = 0;
-    table = new HashEntry[capacity];
+    table = allocateSlots(roundUpPow2(required > initialCapacity ? required : initialCapacity));
+
+    for (int i = 0; i < count; ++i) {
+        InternedString nickname = animals[i].nickname;
+        uint64_t hash = hashInterned(nickname);
+        int slot = findSlot(table, nickname, hash);
+        int index = ids ? (*ids)[i] : i;
+        if (slot != -1) {
+            table.indices[slot] = index;
+            continue;
+        }
+        insertHashed(table, nickname.getId(), index, hash);
+        size++;
+    }
+}
+
+void AnimalHashTable::setMaxLoadFactor(double loadFactor) {
+    if (loadFactor < LOAD_FACTOR_MAX) loadFactor = LOAD_FACTOR_MAX;
+    if (loadFactor > LOAD_FACTOR_LIMIT) loadFactor = LOAD_FACTOR_LIMIT;
+    maxLoadFactor = loadFactor;
+}
+
+void AnimalHashTable::setIncrementalRehash(bool enabled) {
+    incrementalRehash = enabled;
+    if (!enabled && isMigrating()) {
+        finishMigration();
+    }
+}
+
+double AnimalHashTable::getMigrationProgress() const {
+    if (!isMigrating()) return 1.0;
+    return static_cast<double>(migrateCursor) / oldTable.capacity;
 }
 
 void AnimalHashTable::rehash(int newCapacity) {
-    HashEntry* oldTable = table;
-    int oldCapacity = capacity;
+    if (isMigrating()) {
+        finishMigration();
+    }
 
-    table = new HashEntry[newCapacity];
-    capacity = newCapacity;
-    size = 0;
+    oldTable = table;
+    table = allocateSlots(newCapacity);
+    migrateCursor = 0;
+
+    if (!incrementalRehash) {
+        finishMigration();
+    }
+}
+
+void AnimalHashTable::migrate(int slotBudget) const {
+    int end = migrateCursor + slotBudget;
+    if (end > oldTable.capacity) end = oldTable.capacity;
 
-    for (int i = 0; i < oldCapacity; ++i) {
-        if (oldTable[i].status == 1) {
-            insert(oldTable[i].key, oldTable[i].index);
+    for (; migrateCursor < end; ++migrateCursor) {
+        uint8_t ctrl = oldTable.ctrl[migrateCursor];
+        if (ctrl != CTRL_EMPTY && ctrl != CTRL_MOVED) {
+            insertHashed(table, oldTable.keys[migrateCursor],
+                         oldTable.indices[migrateCursor], oldTable.hashes[migrateCursor]);
+            setCtrl(oldTable, migrateCursor, CTRL_MOVED);
         }
     }
 
-    delete[] oldTable;
+    if (migrateCursor == oldTable.capacity) {
+        releaseSlots(oldTable);
+        migrateCursor = 0;
+    }
 }
 
 void AnimalHashTable::print(std::ostream& out) const {
     out << "=== Hash Table Debug Info ===" << std::endl;
-    out << "Capacity: " << capacity << ", Size: " << size
+    out << "Capacity: " << table.capacity << ", Size: " << size
         << ", Load Factor: " << std::fixed << std::setprecision(2)
         << getLoadFactor() << std::endl;
+    if (isMigrating()) {
+        out << "Migrating from capacity " << oldTable.capacity << ": "
+            << static_cast<int>(getMigrationProgress() * 100) << "% done" << std::endl;
+    }
+
+    // Распределение смещений записей относительно их первичного слота
+    DynamicArray<int> displacement;
+    int maxDisplacement = 0;
+    long long totalDisplacement = 0;
+    int placed = 0;
+    for (int i = 0; i < table.capacity; ++i) {
+        if (table.ctrl[i] == CTRL_EMPTY) continue;
+        int distance = probeDistance(table, i);
+        while (static_cast<int>(displacement.size()) <= distance) {
+            displacement.push_back(0);
+        }
+        displacement[distance]++;
+        totalDisplacement += distance;
+        placed++;
+        if (distance > maxDisplacement) maxDisplacement = distance;
+    }
+    out << "Displacement: max=" << maxDisplacement << ", mean="
+        << (placed > 0 ? static_cast<double>(totalDisplacement) / placed : 0.0) << std::endl;
+    for (size_t d = 0; d < displacement.size(); ++d) {
+        out << "  " << std::setw(3) << d << ": " << displacement[d] << "\n";
+    }
     out << std::endl;
 
-    for (int i = 0; i < capacity; ++i) {
+    for (int i = 0; i < table.capacity; ++i) {
         out << "==================================================================\n";
         out << "Slot " << std::setw(3) << i << ": ";
 
-        if (table[i].status == 0) {
+        HashEntry entry = getSlotInfo(i);
+        if (entry.status == 0) {
             out << "Nickname=None, Index=None, Status=0\n";
         } else {
-            out << "Nickname=" << table[i].key
-                << ", Index=" << table[i].index
-                << ", Hash=" << primaryHash(table[i].key)
-                << ", Status=" << table[i].status << "\n";
+            out << "Nickname=" << entry.key
+                << ", Index=" << entry.index
+                << ", Hash=" << slotFor(table, entry.hash)
+                << ", Status=" << entry.status
+                << ", Distance=" << probeDistance(table, i) << "\n";
         }
     }
     out << "==================================================================\n";
 }
 
+void AnimalHashTable::saveSlots(std::ostream& out) {
+    if (isMigrating()) {
+        finishMigration();
+    }
+
+    int32_t header[2] = { table.capacity, size };
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(&seed), sizeof(seed));
+    out.write(reinterpret_cast<const char*>(table.ctrl), table.capacity + GROUP_WIDTH - 1);
+    out.write(reinterpret_cast<const char*>(table.keys), sizeof(uint32_t) * table.capacity);
+    out.write(reinterpret_cast<const char*>(table.indices), sizeof(int) * table.capacity);
+    out.write(reinterpret_cast<const char*>(table.hashes), sizeof(uint64_t) * table.capacity);
+}
+
+bool AnimalHashTable::validSlots(const Slots& slots, uint32_t stringCount, const SlotMap<Animal>& animals,
+                                 int expectedSize) {
+    // Каждый занятый слот должен указывать на живую запись с тем же ключом,
+    // а занятых слотов - ровно size: иначе устаревший id читал бы из SlotMap
+    // звено списка свободных слотов вместо позиции записи. Управляющий байт
+    // занятого слота - фрагмент его хеша, иначе поиск запись не увидит
+    int occupied = 0;
+    int firstEmpty = -1;
+    for (int i = 0; i < slots.capacity; ++i) {
+        if (slots.ctrl[i] == CTRL_EMPTY) {
+            if (firstEmpty < 0) firstEmpty = i;
+            continue;
+        }
+        ++occupied;
+        if (slots.ctrl[i] != fragmentOf(slots.hashes[i]) || slots.keys[i] >= stringCount ||
+            !animals.contains(slots.indices[i]) ||
+            animals.get(slots.indices[i]).nickname.getId() != slots.keys[i]) {
+            return false;
+        }
+    }
+    // Хотя бы один пустой слот: на нём останавливаются insertHashed и eraseSlot
+    if (occupied != expectedSize || firstEmpty < 0) {
+        return false;
+    }
+    // Хвост управляющих байтов повторяет начало таблицы
+    for (int i = 0; i < GROUP_WIDTH - 1; ++i) {
+        if (slots.ctrl[slots.capacity + i] != slots.ctrl[i]) {
+            return false;
+        }
+    }
+    // Между первичным слотом записи и ней самой нет пустых слотов: обход идёт
+    // от пустого слота, run - длина текущей цепочки занятых
+    int mask = slots.capacity - 1;
+    int run = 0;
+    for (int step = 1; step <= slots.capacity; ++step) {
+        int slot = (firstEmpty + step) & mask;
+        if (slots.ctrl[slot] == CTRL_EMPTY) {
+            run = 0;
+            continue;
+        }
+        if (probeDistance(slots, slot) > run) {
+            return false;
+        }
+        ++run;
+    }
+    return true;
+}
+
+bool AnimalHashTable::loadSlots(const char*& cursor, const char* end, uint32_t stringCount,
+                                const SlotMap<Animal>& animals) {
+    int32_t header[2];
+    uint64_t fileSeed;
+    if (static_cast<size_t>(end - cursor) < sizeof(header) + sizeof(fileSeed)) {
+        return false;
+    }
+    std::memcpy(header, cursor, sizeof(header));
+    std::memcpy(&fileSeed, cursor + sizeof(header), sizeof(fileSeed));
+
+    int newCapacity = header[0];
+    int newSize = header[1];
+    if (newCapacity < GROUP_WIDTH || (newCapacity & (newCapacity - 1)) != 0 ||
+        newSize < 0 || newSize >= newCapacity || static_cast<size_t>(newSize) != animals.size()) {
+        return false;
+    }
+    size_t ctrlBytes = static_cast<size_t>(newCapacity) + GROUP_WIDTH - 1;
+    size_t needed = sizeof(header) + sizeof(fileSeed) + ctrlBytes +
+                    static_cast<size_t>(newCapacity) * (sizeof(uint32_t) + sizeof(int) + sizeof(uint64_t));
+    if (static_cast<size_t>(end - cursor) < needed) {
+        return false;
+    }
+    const char* data = cursor + sizeof(header) + sizeof(fileSeed);
+
+    Slots loaded = allocateSlots(newCapacity);
+    // Хеши и управляющие байты зависят только от текста ключа, поэтому переносятся как есть
+    std::memcpy(loaded.ctrl, data, ctrlBytes);
+    data += ctrlBytes;
+    std::memcpy(loaded.keys, data, sizeof(uint32_t) * newCapacity);
+    data += sizeof(uint32_t) * newCapacity;
+    std::memcpy(loaded.indices, data, sizeof(int) * newCapacity);
+    data += sizeof(int) * newCapacity;
+    std::memcpy(loaded.hashes, data, sizeof(uint64_t) * newCapacity);
+    data += sizeof(uint64_t) * newCapacity;
+
+    if (!validSlots(loaded, stringCount, animals, newSize)) {
+        releaseSlots(loaded);
+        return false;
+    }
+
+    releaseSlots(table);
+    releaseSlots(oldTable);
+    migrateCursor = 0;
+    table = loaded;
+    size = newSize;
+    seed = fileSeed;
+    cursor = data;
+    return true;
+}
+
+void AnimalHashTable::remapKeys(const uint32_t* remap) {
+    for (int i = 0; i < table.capacity; ++i) {
+        if (table.ctrl[i] != CTRL_EMPTY) {
+            table.keys[i] = remap[table.keys[i]];
+        }
+    }
+}
+
 bool AnimalHashTable::importFromFile(const std::string& filename,
                                      DynamicArray<Animal>& animals,
                                      int maxLines) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    // Массив очищается только после успешного открытия: при ошибке и он,
+    // и таблица остаются прежними
+    MappedFile file;
+    if (!file.open(filename)) {
         return false;
     }
-
     animals.clear();
-    clear();
 
-    std::string line;
-    int index = 0;
     int linesRead = 0;
-
-    while (std::getline(file, line)) {
+    TextLoader::forEachLine(file.data(), file.data() + file.size(), [&](std::string_view line) {
         if (maxLines > 0 && linesRead >= maxLines) {
-            break;
+            return false;
         }
 
-        std::istringstream iss(line);
-        Animal animal;
-
-        if (!(iss >> animal.nickname >> animal.species >> animal.cage)) {
-            continue;
+        std::string_view fields[3];
+        if (TextLoader::splitFields(line, fields, 3) < 3) {
+            return true;
         }
 
-        animals.push_back(animal);
-        insert(animal.nickname, index);
-        index++;
+        animals.push_back(Animal(fields[0], fields[1], fields[2]));
         linesRead++;
-    }
+        return true;
+    });
 
-    file.close();
+    build(animals);
     return true;
 }
 
@@ -0,0 +1,93 @@
+#include "Arena.h"
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+    // Верхняя граница роста блоков, чтобы не держать лишние гигабайты
+    const size_t MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+
+    size_t blockHeader() {
+        const size_t align = alignof(std::max_align_t);
+        return (sizeof(void*) + sizeof(size_t) + align - 1) / align * align;
+    }
+}
+
+MonotonicArena::MonotonicArena(size_t initialBlockSize)
+    : current(nullptr), cursor(nullptr), limit(nullptr),
+      initialBlockSize(initialBlockSize > 0 ? initialBlockSize : 4096),
+      bytesUsed(0), bytesReserved(0) {}
+
+MonotonicArena::~MonotonicArena() {
+    while (current) {
+        Block* prev = current->prev;
+        std::free(current);
+        current = prev;
+    }
+}
+
+void MonotonicArena::addBlock(size_t minBytes) {
+    size_t size = current ? current->size * 2 : initialBlockSize;
+    if (size > MAX_BLOCK_SIZE) size = MAX_BLOCK_SIZE;
+    if (size < minBytes) size = minBytes;
+
+    void* memory = std::malloc(blockHeader() + size);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    Block* block = static_cast<Block*>(memory);
+    block->prev = current;
+    block->size = size;
+    current = block;
+    cursor = static_cast<char*>(memory) + blockHeader();
+    limit = cursor + size;
+    bytesReserved += size;
+}
+
+void* MonotonicArena::allocate(size_t bytes, size_t alignment) {
+    if (bytes == 0) bytes = 1;
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if (!cursor || aligned + bytes > reinterpret_cast<uintptr_t>(limit)) {
+        addBlock(bytes + alignment);
+        aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    }
+    char* result = reinterpret_cast<char*>(aligned);
+    bytesUsed += static_cast<size_t>(result + bytes - cursor);
+    cursor = result + bytes;
+    return result;
+}
+
+void MonotonicArena::deallocate(void* ptr, size_t bytes) {
+    // Откат последнего выделения: рост массива на вершине арены не оставляет мусора
+    char* p = static_cast<char*>(ptr);
+    if (p && p + bytes == cursor) {
+        cursor = p;
+        bytesUsed -= bytes;
+    }
+}
+
+void MonotonicArena::reset() {
+    // Оставляем самый большой блок, остальные освобождаем. Последний блок
+    // не обязательно самый большой: после выделения больше MAX_BLOCK_SIZE
+    // следующий блок снова ограничен MAX_BLOCK_SIZE
+    Block* largest = current;
+    for (Block* block = current; block; block = block->prev) {
+        if (block->size > largest->size) {
+            largest = block;
+        }
+    }
+    while (current) {
+        Block* prev = current->prev;
+        if (current != largest) {
+            bytesReserved -= current->size;
+            std::free(current);
+        }
+        current = prev;
+    }
+    current = largest;
+    if (current) {
+        current->prev = nullptr;
+        cursor = reinterpret_cast<char*>(current) + blockHeader();
+        limit = cursor + current->size;
+    }
+    bytesUsed = 0;
+}
@@ -1,35 +1,114 @@
 #include "CircularList.h"
+#include "Arena.h"
+#include <new>
+#include <utility>
+
+namespace {
+    size_t slabHeader() {
+        const size_t align = alignof(std::max_align_t);
+        return (sizeof(void*) + align - 1) / align * align;
+    }
+}
+
+ListNodePool::ListNodePool(MonotonicArena* arena, int nodesPerSlab)
+    : arena(arena), nodesPerSlab(nodesPerSlab > 0 ? nodesPerSlab : 256), slabs(nullptr),
+      cursor(nullptr), limit(nullptr), freeHead(nullptr), nodesInUse(0), slabCount(0) {}
+
+ListNodePool::~ListNodePool() {
+    reset();
+}
+
+void ListNodePool::addSlab() {
+    size_t bytes = slabHeader() + sizeof(CircularList::Node) * nodesPerSlab;
+    void* memory = arena ? arena->allocate(bytes) : ::operator new(bytes);
+    Slab* slab = static_cast<Slab*>(memory);
+    slab->prev = slabs;
+    slabs = slab;
+    cursor = reinterpret_cast<CircularList::Node*>(static_cast<char*>(memory) + slabHeader());
+    limit = cursor + nodesPerSlab;
+    slabCount++;
+}
+
+void* ListNodePool::allocate() {
+    nodesInUse++;
+    if (freeHead) {
+        CircularList::Node* node = freeHead;
+        freeHead = node->next;
+        return node;
+    }
+    if (cursor == limit) {
+        addSlab();
+    }
+    return cursor++;
+}
+
+void ListNodePool::release(CircularList::Node* first, CircularList::Node* last, int count) {
+    last->next = freeHead;
+    freeHead = first;
+    nodesInUse -= count;
+}
+
+void ListNodePool::reset() {
+    // Плиты из арены освободит её владелец
+    if (!arena) {
+        while (slabs) {
+            Slab* prev = slabs->prev;
+            ::operator delete(slabs);
+            slabs = prev;
+        }
+    }
+    slabs = nullptr;
+    cursor = limit = freeHead = nullptr;
+    nodesInUse = 0;
+    slabCount = 0;
+}
 
 CircularList::Node::Node(int d)
     : data(d), next(this), prev(this) {}
 
-CircularList::CircularList() : head(nullptr) {}
+CircularList::CircularList() : head(nullptr), count(0), pool(nullptr) {}
+
+CircularList::CircularList(ListNodePool* pool) : head(nullptr), count(0), pool(pool) {}
 
 CircularList::~CircularList() {
-    if (!head) return;
-    Node* cur = head->next;
-    while (cur != head) {
-        Node* tmp = cur;
-        cur = cur->next;
-        delete tmp;
+    clear();
+}
+
+CircularList::Node* CircularList::createNode(int value) {
+    if (pool) {
+        return ::new (pool->allocate()) Node(value);
+    }
+    return new Node(value);
+}
+
+void CircularList::destroyNode(Node* node) {
+    if (pool) {
+        pool->release(node, node, 1);
+    } else {
+        delete node;
     }
-    delete head;
 }
 
 void CircularList::clear() {
     if (!head) return;
-    Node* cur = head->next;
-    while (cur != head) {
-        Node* tmp = cur;
-        cur = cur->next;
-        delete tmp;
+    if (pool) {
+        // Кольцо целиком уходит в список свободных пула
+        pool->release(head, head->prev, count);
+    } else {
+        Node* cur = head->next;
+        while (cur != head) {
+            Node* tmp = cur;
+            cur = cur->next;
+            delete tmp;
+        }
+        delete head;
     }
-    delete head;
     head = nullptr;
+    count = 0;
 }
 
 void CircularList::add(int value) {
-    Node* node = new Node(value);
+    Node* node = createNode(value);
     if (!head) {
         head = node;
     } else {
@@ -39,26 +118,64 @@ void CircularList::add(int value) {
         node->next = head;
         head->prev = node;
     }
+    count++;
+}
+
+void CircularList::append(const CircularList &other) {
+    // Число элементов фиксируется заранее, поэтому append(*this) тоже конечен
+    int n = other.count;
+    const_iterator it = other.begin();
+    for (int i = 0; i < n; ++i, ++it) {
+        add(*it);
+    }
+}
+
+void CircularList::splice(CircularList &other) {
+    if (&other == this || !other.head) return;
+    if (other.pool != pool) {
+        append(other);
+        other.clear();
+        return;
+    }
+    if (!head) {
+        head = other.head;
+    } else {
+        Node* tail = head->prev;
+        Node* otherTail = other.head->prev;
+        tail->next = other.head;
+        other.head->prev = tail;
+        otherTail->next = head;
+        head->prev = otherTail;
+    }
+    count += other.count;
+    other.head = nullptr;
+    other.count = 0;
 }
 
 void CircularList::removeAll(int value) {
     if (!head) return;
+    // Обход до исходного хвоста: head может сместиться при удалении
+    Node* last = head->prev;
     Node* cur = head;
-    do {
+    bool done = false;
+    while (!done) {
+        done = (cur == last);
+        Node* next = cur->next;
         if (cur->data == value) {
-            Node* toDel = cur;
             if (cur->next == cur) {
                 head = nullptr;
-                delete toDel;
+                count = 0;
+                destroyNode(cur);
                 return;
             }
             cur->prev->next = cur->next;
             cur->next->prev = cur->prev;
-            if (toDel == head) head = head->next;
-            cur = cur->next;
-            delete toDel;
-        } else cur = cur->next;
-    } while (cur != head);
+            if (cur == head) head = next;
+            destroyNode(cur);
+            count--;
+        }
+        cur = next;
+    }
 }
 
 void CircularList::removeBeforeValue(int value) {
@@ -76,7 +193,8 @@ void CircularList::removeBeforeValue(int value) {
                 head = cur;
             }
 
-            delete toDel;
+            destroyNode(toDel);
+            count--;
 
         }
         cur = cur->next;
@@ -95,14 +213,6 @@ int CircularList::find(int value) const {
     return -1;
 }
 
-int CircularList::size() const {
-    if (!head) return 0;
-    int cnt = 1;
-    Node* cur = head->next;
-    while (cur != head) { cnt++; cur = cur->next; }
-    return cnt;
-}
-
 int CircularList::toNumber() const {
     if (!head) return 0;
     int num = 0;
@@ -135,17 +245,20 @@ void CircularList::copyFrom(const CircularList &other) {
 }
 
 int CircularList::get(int index) const {
-    if (!head || index < 0 || index >= size()) {
+    if (!head || index < 0 || index >= count) {
         return -1;
     }
+    // Идём с ближнего конца кольца
     Node* cur = head;
-    for (int i = 0; i < index; ++i) {
-        cur = cur->next;
+    if (index <= count / 2) {
+        for (int i = 0; i < index; ++i) cur = cur->next;
+    } else {
+        for (int i = count; i > index; --i) cur = cur->prev;
     }
     return cur->data;
 }
 
-CircularList::CircularList(const CircularList &other) : head(nullptr) {
+CircularList::CircularList(const CircularList &other) : head(nullptr), count(0), pool(nullptr) {
     copyFrom(other);
 }
 
@@ -154,4 +267,28 @@ CircularList& CircularList::operator=(const CircularList &other) {
         copyFrom(other);
     }
     return *this;
-}
\ No newline at end of file
+}
+
+CircularList::CircularList(CircularList &&other) noexcept
+    : head(other.head), count(other.count), pool(other.pool) {
+    other.head = nullptr;
+    other.count = 0;
+}
+
+CircularList& CircularList::operator=(CircularList &&other) noexcept {
+    if (this != &other) {
+        clear();
+        head = other.head;
+        count = other.count;
+        pool = other.pool;
+        other.head = nullptr;
+        other.count = 0;
+    }
+    return *this;
+}
+
+void CircularList::swap(CircularList &other) noexcept {
+    std::swap(head, other.head);
+    std::swap(count, other.count);
+    std::swap(pool, other.pool);
+}
@@ -0,0 +1,84 @@
+#include "DateUtils.h"
+
+namespace {
+    bool readDigits(std::string_view text, size_t pos, size_t count, int& value) {
+        value = 0;
+        for (size_t i = pos; i < pos + count; ++i) {
+            if (text[i] < '0' || text[i] > '9') {
+                return false;
+            }
+            value = value * 10 + (text[i] - '0');
+        }
+        return true;
+    }
+
+    bool isLeapYear(int year) {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+
+    int daysInMonth(int year, int month) {
+        static const int DAYS[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        return (month == 2 && isLeapYear(year)) ? 29 : DAYS[month - 1];
+    }
+}
+
+namespace DateUtils {
+    // Алгоритм days_from_civil Говарда Хиннанта: год сдвигается так, чтобы
+    // февраль был последним месяцем, дальше - целочисленная арифметика эр по 400 лет
+    int32_t daysFromCivil(int year, int month, int day) {
+        year -= month <= 2;
+        const int era = (year >= 0 ? year : year - 399) / 400;
+        const int yearOfEra = year - era * 400;
+        const int dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + dayOfEra - 719468;
+    }
+
+    void civilFromDays(int32_t dayNumber, int& year, int& month, int& day) {
+        dayNumber += 719468;
+        const int era = (dayNumber >= 0 ? dayNumber : dayNumber - 146096) / 146097;
+        const int dayOfEra = dayNumber - era * 146097;
+        const int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        const int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        const int shiftedMonth = (5 * dayOfYear + 2) / 153;
+        day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+        month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+        year = yearOfEra + era * 400 + (month <= 2);
+    }
+
+    bool parseDate(std::string_view text, int32_t& dayNumber) {
+        if (text.length() != 10 || text[2] != '.' || text[5] != '.') {
+            return false;
+        }
+        int day, month, year;
+        if (!readDigits(text, 0, 2, day) || !readDigits(text, 3, 2, month) || !readDigits(text, 6, 4, year)) {
+            return false;
+        }
+        if (year < MIN_YEAR || year > MAX_YEAR || month < 1 || month > 12 ||
+            day < 1 || day > daysInMonth(year, month)) {
+            return false;
+        }
+        dayNumber = daysFromCivil(year, month, day);
+        return true;
+    }
+
+    bool isValidDateFormat(std::string_view text) {
+        int32_t dayNumber;
+        return parseDate(text, dayNumber);
+    }
+
+    std::string formatDate(int32_t dayNumber) {
+        int year, month, day;
+        civilFromDays(dayNumber, year, month, day);
+        std::string text = "00.00.0000";
+        text[0] = static_cast<char>('0' + day / 10);
+        text[1] = static_cast<char>('0' + day % 10);
+        text[3] = static_cast<char>('0' + month / 10);
+        text[4] = static_cast<char>('0' + month % 10);
+        for (int i = 9; i >= 6; --i) {
+            text[i] = static_cast<char>('0' + year % 10);
+            year /= 10;
+        }
+        return text;
+    }
+}
@@ -1,51 +1,191 @@
 #include "FeedingTree.h"
+#include "TextLoader.h"
+#include "AnimalHashTable.h"
+#include "MappedFile.h"
+#include "DateUtils.h"
+#include "HashUtils.h"
 #include <fstream>
-#include <sstream>
 #include <utility>
 #include <iomanip>
 
-FeedingNode::FeedingNode(std::string k, int idx)
-    : key(std::move(k)), balance(0), left(nullptr), right(nullptr) {
+FeedingNode::FeedingNode(InternedString k, int idx, ListNodePool* pool)
+    : key(k), balance(0), left(nullptr), right(nullptr), indices(pool) {
     indices.add(idx);
 }
 
-FeedingTree::FeedingTree() : root(nullptr) {}
+FeedingTree::FeedingTree(MonotonicArena* arena)
+    : root(nullptr), arena(arena), freeNodes(nullptr), listPool(arena) {}
 FeedingTree::~FeedingTree() { clear(); }
 
 void FeedingTree::clear() {
-    clearNode(root);
+    // Ключ и список узла в арене ничего не держат вне её
+    if (!arena) {
+        clearNode(root);
+    }
     root = nullptr;
+    freeNodes = nullptr;
+    listPool.reset();
 }
 
 void FeedingTree::clearNode(FeedingNode* node) {
     if (!node) return;
     clearNode(node->left);
     clearNode(node->right);
-    delete node;
+    destroyNode(node);
+}
+
+FeedingNode* FeedingTree::createNode(InternedString key, int index) {
+    if (arena) {
+        if (freeNodes) {
+            void* memory = freeNodes;
+            freeNodes = *static_cast<void**>(memory);
+            return ::new (memory) FeedingNode(key, index, &listPool);
+        }
+        return arena->create<FeedingNode>(key, index, &listPool);
+    }
+    return new FeedingNode(key, index, &listPool);
+}
+
+void FeedingTree::destroyNode(FeedingNode* node) {
+    if (arena) {
+        // Память узла уходит в список свободных и достаётся следующей вставке
+        node->~FeedingNode();
+        *reinterpret_cast<void**>(node) = freeNodes;
+        freeNodes = node;
+    } else {
+        delete node;
+    }
+}
+
+namespace {
+    // Одно сравнение на уровень: совпадение видно по id, порядок - по тексту
+    // (как у operator< InternedString, по которому сортирует buildFromSorted)
+    int compareKeys(InternedString a, InternedString b) {
+        return a == b ? 0 : a.view().compare(b.view());
+    }
 }
 
-void FeedingTree::add(const std::string& nickname, int index) {
-    bool inc = false;
-    root = insertNode(root, nickname, index, inc);
+// Вставка и удаление без рекурсии: спуск запоминает адреса ссылок на узлы
+// пути (поле предка или root) и направление шага, подъём идёт по ним и
+// заканчивается на первом предке, чья высота не изменилась
+void FeedingTree::add(InternedString nickname, int index) {
+    FeedingNode** path[MAX_DEPTH];
+    int dirs[MAX_DEPTH];
+    int depth = 0;
+    FeedingNode** link = &root;
+    while (*link) {
+        FeedingNode* node = *link;
+        int cmp = compareKeys(nickname, node->key);
+        if (cmp == 0) {
+            node->indices.add(index);
+            return;
+        }
+        path[depth] = link;
+        dirs[depth++] = cmp;
+        link = cmp < 0 ? &node->left : &node->right;
+    }
+    *link = createNode(nickname, index);
+
+    bool heightInc = true;
+    while (heightInc && depth > 0) {
+        --depth;
+        FeedingNode** at = path[depth];
+        *at = dirs[depth] < 0 ? balanceLeftInsert(*at, heightInc) : balanceRightInsert(*at, heightInc);
+    }
 }
 
-void FeedingTree::remove(const std::string& nickname, int index) {
-    bool dec = false;
-    root = deleteNode(root, nickname, index, dec);
+void FeedingTree::remove(InternedString nickname, int index) {
+    FeedingNode** path[MAX_DEPTH];
+    int dirs[MAX_DEPTH];
+    int depth = 0;
+    FeedingNode** link = &root;
+    while (*link) {
+        int cmp = compareKeys(nickname, (*link)->key);
+        if (cmp == 0) break;
+        path[depth] = link;
+        dirs[depth++] = cmp;
+        link = cmp < 0 ? &(*link)->left : &(*link)->right;
+    }
+    FeedingNode* node = *link;
+    if (!node) return;
+    node->indices.removeAll(index);
+    if (node->indices.size() > 0) return;
+
+    if (node->left && node->right) {
+        // Ключ и список предшественника переезжают в узел, удаляется сам предшественник
+        path[depth] = link;
+        dirs[depth++] = -1;
+        link = &node->left;
+        while ((*link)->right) {
+            path[depth] = link;
+            dirs[depth++] = 1;
+            link = &(*link)->right;
+        }
+        FeedingNode* pred = *link;
+        node->key = pred->key;
+        node->indices.swap(pred->indices);
+        node = pred;
+    }
+    *link = node->left ? node->left : node->right;
+    destroyNode(node);
+
+    bool heightDec = true;
+    while (heightDec && depth > 0) {
+        --depth;
+        FeedingNode** at = path[depth];
+        *at = dirs[depth] < 0 ? balanceLeft(*at, heightDec) : balanceRight(*at, heightDec);
+    }
 }
 
-CircularList FeedingTree::search(const std::string& nickname) const {
+void FeedingTree::buildFromSorted(const BuildEntry* entries, size_t count) {
+    clear();
+    DynamicArray<size_t> groupStarts;
+    for (size_t i = 0; i < count; ++i) {
+        if (i == 0 || entries[i - 1].key < entries[i].key) {
+            groupStarts.push_back(i);
+        }
+    }
+    groupStarts.push_back(count);
+    int height;
+    root = buildRange(entries, groupStarts.data(), 0, groupStarts.size() - 1, height);
+}
+
+FeedingNode* FeedingTree::buildRange(const BuildEntry* entries, const size_t* groupStarts,
+                                     size_t lo, size_t hi, int &height) {
+    if (lo >= hi) {
+        height = 0;
+        return nullptr;
+    }
+    // Корень - середина: слева n / 2 групп, справа n - n / 2 - 1 (n = hi - lo),
+    // высоты половин отличаются не больше чем на 1
+    size_t mid = lo + (hi - lo) / 2;
+    int leftHeight, rightHeight;
+    FeedingNode* left = buildRange(entries, groupStarts, lo, mid, leftHeight);
+    FeedingNode* node = createNode(entries[groupStarts[mid]].key, entries[groupStarts[mid]].index);
+    for (size_t i = groupStarts[mid] + 1; i < groupStarts[mid + 1]; ++i) {
+        node->indices.add(entries[i].index);
+    }
+    node->left = left;
+    node->right = buildRange(entries, groupStarts, mid + 1, hi, rightHeight);
+    node->balance = rightHeight - leftHeight;
+    height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+    return node;
+}
+
+PostingsView<CircularList> FeedingTree::search(std::string_view nickname) const {
+    InternedString key = InternedString::lookup(nickname);
+    if (!key.isValid()) {
+        return PostingsView<CircularList>();
+    }
     FeedingNode* cur = root;
     while (cur) {
-        if (nickname < cur->key) {
-            cur = cur->left;
-        } else if (nickname > cur->key) {
-            cur = cur->right;
-        } else {
-            return cur->indices;
+        int cmp = compareKeys(key, cur->key);
+        if (cmp == 0) {
+            return PostingsView<CircularList>(cur->indices);
         }
+        cur = cmp < 0 ? cur->left : cur->right;
     }
-    return CircularList();
+    return PostingsView<CircularList>();
 }
 
 void FeedingTree::print(std::ostream &out) const {
@@ -68,18 +208,184 @@ void FeedingTree::prettyPrint(FeedingNode* node, std::ostream &out, const std::s
     }
 }
 
-bool FeedingTree::importFromFile(const std::string &filename, DynamicArray<FeedingEntry> &outEntries, int maxLines) {
-    std::ifstream in(filename);
-    if (!in.is_open()) return false;
-    std::string line;
+bool FeedingTree::importFromFile(const std::string &filename, DynamicArray<FeedingEntry> &outEntries, int maxLines,
+                                 const AnimalHashTable* knownAnimals, int* skippedUnknown) {
     int linesRead = 0;
-    while (std::getline(in, line)) {
-        if (maxLines > 0 && linesRead >= maxLines) break;
-        std::istringstream iss(line);
-        FeedingEntry e;
-        if (!(iss >> e.nickname >> e.feedType >> e.quantity >> e.date)) continue;
-        outEntries.push_back(e);
+    if (skippedUnknown) *skippedUnknown = 0;
+    return TextLoader::forEachLine(filename, [&](std::string_view line) {
+        if (maxLines > 0 && linesRead >= maxLines) return false;
+        std::string_view fields[4];
+        int quantity;
+        int32_t date;
+        if (TextLoader::splitFields(line, fields, 4) < 4 || !TextLoader::parseInt(fields[2], quantity) ||
+            !DateUtils::parseDate(fields[3], date)) return true;
+        if (knownAnimals) {
+            int steps;
+            if (knownAnimals->search(fields[0], steps) < 0) {
+                if (skippedUnknown) (*skippedUnknown)++;
+                return true;
+            }
+        }
+        outEntries.push_back(FeedingEntry{fields[0], fields[1], quantity, date});
         linesRead++;
+        return true;
+    });
+}
+
+namespace {
+    // Различные строки одного куска: string_view на файл -> локальный id.
+    // Поток не трогает общий пул, в него потом добавляются только эти строки
+    class ChunkStrings {
+    public:
+        ChunkStrings() : mask(0) {}
+
+        uint32_t localId(std::string_view text) {
+            if ((texts.size() + 1) * 2 > slots.size()) {
+                grow();
+            }
+            uint64_t hash = HashUtils::hashBytes(text, HashUtils::DEFAULT_SEED);
+            uint32_t slot = static_cast<uint32_t>(hash) & mask;
+            while (slots[slot] != StringPool::NO_ID) {
+                uint32_t id = slots[slot];
+                if (hashes[id] == hash && texts[id] == text) {
+                    return id;
+                }
+                slot = (slot + 1) & mask;
+            }
+            uint32_t id = static_cast<uint32_t>(texts.size());
+            texts.push_back(text);
+            hashes.push_back(hash);
+            slots[slot] = id;
+            return id;
+        }
+
+        size_t size() const { return texts.size(); }
+        std::string_view text(uint32_t id) const { return texts[id]; }
+
+    private:
+        DynamicArray<std::string_view> texts;
+        DynamicArray<uint64_t> hashes;
+        DynamicArray<uint32_t> slots;
+        uint32_t mask;
+
+        void grow() {
+            size_t capacity = slots.size() == 0 ? 64 : slots.size() * 2;
+            slots.clear();
+            slots.reserve(capacity);
+            for (size_t i = 0; i < capacity; ++i) {
+                slots.push_back(StringPool::NO_ID);
+            }
+            mask = static_cast<uint32_t>(capacity - 1);
+            for (uint32_t id = 0; id < texts.size(); ++id) {
+                uint32_t slot = static_cast<uint32_t>(hashes[id]) & mask;
+                while (slots[slot] != StringPool::NO_ID) {
+                    slot = (slot + 1) & mask;
+                }
+                slots[slot] = id;
+            }
+        }
+    };
+
+    // Строка кормления с локальными id строк куска
+    struct RawFeeding {
+        uint32_t nickname;
+        uint32_t feedType;
+        int quantity;
+        int32_t date;
+    };
+
+    // Флаги локальной строки: кличка проверена по таблице, животное известно,
+    // строка нужна хотя бы одной принятой записи
+    const uint8_t STRING_CHECKED = 1;
+    const uint8_t STRING_KNOWN = 2;
+    const uint8_t STRING_USED = 4;
+
+    struct FeedingChunk {
+        ChunkStrings strings;
+        DynamicArray<uint8_t> flags;
+        DynamicArray<RawFeeding> rows;
+        int skipped = 0;
+    };
+
+    // Меньшие куски не окупают запуск потока
+    const size_t MIN_PARALLEL_CHUNK = 1 << 20;
+}
+
+bool FeedingTree::importFromFileParallel(const std::string &filename, DynamicArray<FeedingEntry> &outEntries,
+                                         const AnimalHashTable* knownAnimals, int* skippedUnknown,
+                                         int threadCount) {
+    int workers = TextLoader::workerCount(threadCount);
+    if (workers == 1) {
+        // Одному потоку промежуточные локальные id ничего не дают
+        return importFromFile(filename, outEntries, 0, knownAnimals, skippedUnknown);
+    }
+
+    MappedFile file;
+    if (!file.open(filename)) return false;
+    if (skippedUnknown) *skippedUnknown = 0;
+    if (file.size() == 0) return true;
+
+    // Разбор, поиск клички в таблице и свёртка строк в локальные id идут
+    // параллельно: searchConcurrent() таблицу не меняет, общий пул строк не трогается
+    DynamicArray<FeedingChunk> chunks;
+    chunks.reserve(workers);
+    for (int part = 0; part < workers; ++part) {
+        chunks.emplace_back();
+    }
+    int parts = TextLoader::forEachChunkParallel(file.data(), file.data() + file.size(), workers,
+                                                 MIN_PARALLEL_CHUNK,
+                                                 [&](int part, const char* begin, const char* end) {
+        FeedingChunk& chunk = chunks[part];
+        TextLoader::forEachLine(begin, end, [&](std::string_view line) {
+            std::string_view fields[4];
+            RawFeeding row;
+            if (TextLoader::splitFields(line, fields, 4) < 4 || !TextLoader::parseInt(fields[2], row.quantity) ||
+                !DateUtils::parseDate(fields[3], row.date)) {
+                return true;
+            }
+            row.nickname = chunk.strings.localId(fields[0]);
+            row.feedType = chunk.strings.localId(fields[1]);
+            while (chunk.flags.size() < chunk.strings.size()) {
+                chunk.flags.push_back(0);
+            }
+            uint8_t& nickname = chunk.flags[row.nickname];
+            if (!(nickname & STRING_CHECKED)) {
+                // Таблица спрашивается один раз на кличку куска
+                int steps;
+                bool known = !knownAnimals || knownAnimals->searchConcurrent(fields[0], steps) >= 0;
+                nickname |= STRING_CHECKED | (known ? STRING_KNOWN : 0);
+            }
+            if (!(nickname & STRING_KNOWN)) {
+                chunk.skipped++;
+                return true;
+            }
+            nickname |= STRING_USED;
+            chunk.flags[row.feedType] |= STRING_USED;
+            chunk.rows.push_back(row);
+            return true;
+        });
+    });
+
+    // Склейка в порядке файла: в пул добавляются только различные строки
+    // каждого куска, затем локальные id переводятся в id пула
+    size_t total = 0;
+    for (int part = 0; part < parts; ++part) total += chunks[part].rows.size();
+    outEntries.reserve(outEntries.size() + total);
+    DynamicArray<InternedString> remap;
+    for (int part = 0; part < parts; ++part) {
+        const FeedingChunk& chunk = chunks[part];
+        remap.clear();
+        remap.reserve(chunk.strings.size());
+        for (uint32_t id = 0; id < chunk.strings.size(); ++id) {
+            // Строки только отвергнутых записей в пул не попадают
+            bool used = chunk.flags[id] & STRING_USED;
+            remap.push_back(used ? InternedString(chunk.strings.text(id)) : InternedString());
+        }
+        for (size_t i = 0; i < chunk.rows.size(); ++i) {
+            const RawFeeding& row = chunk.rows[i];
+            outEntries.push_back(FeedingEntry{remap[row.nickname], remap[row.feedType], row.quantity, row.date});
+        }
+        if (skippedUnknown) *skippedUnknown += chunk.skipped;
     }
     return true;
 }
@@ -93,7 +399,7 @@ bool FeedingTree::exportToFile(const std::string& filename, const DynamicArray<F
     for (size_t i = 0; i < feedings.size(); ++i) {
         const auto& entry = feedings[i];
         file << entry.nickname << " " << entry.feedType << " "
-             << entry.quantity << " " << entry.date << std::endl;
+             << entry.quantity << " " << DateUtils::formatDate(entry.date) << std::endl;
     }
 
     file.close();
@@ -120,6 +426,28 @@ FeedingNode* FeedingTree::rotateRight(FeedingNode* a) {
     return b;
 }
 
+// Двойные повороты: балансы считаются по балансу среднего узла g,
+// одиночные rotateLeft/rotateRight этого не учитывают
+FeedingNode* FeedingTree::rotateLeftRight(FeedingNode* a) {
+    int g = a->left->right->balance;
+    a->left = rotateLeft(a->left);
+    FeedingNode* b = rotateRight(a);
+    b->left->balance = (g == 1) ? -1 : 0;
+    b->right->balance = (g == -1) ? 1 : 0;
+    b->balance = 0;
+    return b;
+}
+
+FeedingNode* FeedingTree::rotateRightLeft(FeedingNode* a) {
+    int g = a->right->left->balance;
+    a->right = rotateRight(a->right);
+    FeedingNode* b = rotateLeft(a);
+    b->left->balance = (g == 1) ? -1 : 0;
+    b->right->balance = (g == -1) ? 1 : 0;
+    b->balance = 0;
+    return b;
+}
+
 FeedingNode* FeedingTree::balanceLeftInsert(FeedingNode* node, bool &heightInc) {
     if (node->balance == 1) { node->balance = 0; heightInc = false; }
     else if (node->balance == 0) { node->balance = -1; }
@@ -127,8 +455,7 @@ FeedingNode* FeedingTree::balanceLeftInsert(FeedingNode* node, bool &heightInc)
         if (node->left->balance <= 0) {
             node = rotateRight(node);
         } else {
-            node->left = rotateLeft(node->left);
-            node = rotateRight(node);
+            node = rotateLeftRight(node);
         }
         heightInc = false;
     }
@@ -142,8 +469,7 @@ FeedingNode* FeedingTree::balanceRightInsert(FeedingNode* node, bool &heightInc)
         if (node->right->balance >= 0) {
             node = rotateLeft(node);
         } else {
-            node->right = rotateRight(node->right);
-            node = rotateLeft(node);
+            node = rotateRightLeft(node);
         }
         heightInc = false;
     }
@@ -155,10 +481,11 @@ FeedingNode* FeedingTree::balanceLeft(FeedingNode* node, bool &heightDec) {
     else if (node->balance == 0) { node->balance = 1; heightDec = false; }
     else {
         if (node->right->balance >= 0) {
+            // При сбалансированном правом сыне высота после поворота не меняется
+            if (node->right->balance == 0) heightDec = false;
             node = rotateLeft(node);
         } else {
-            node->right = rotateRight(node->right);
-            node = rotateLeft(node);
+            node = rotateRightLeft(node);
         }
     }
     return node;
@@ -169,67 +496,11 @@ FeedingNode* FeedingTree::balanceRight(FeedingNode* node, bool &heightDec) {
     else if (node->balance == 0) { node->balance = -1; heightDec = false; }
     else {
         if (node->left->balance <= 0) {
+            if (node->left->balance == 0) heightDec = false;
             node = rotateRight(node);
         } else {
-            node->left = rotateLeft(node->left);
-            node = rotateRight(node);
+            node = rotateLeftRight(node);
         }
     }
     return node;
 }
-
-FeedingNode* FeedingTree::insertNode(FeedingNode* node, const std::string& key, int index, bool &heightInc) {
-    if (!node) {
-        heightInc = true;
-        return new FeedingNode(key, index);
-    }
-    if (key < node->key) {
-        node->left = insertNode(node->left, key, index, heightInc);
-        if (heightInc) node = balanceLeftInsert(node, heightInc);
-    } else if (key > node->key) {
-        node->right = insertNode(node->right, key, index, heightInc);
-        if (heightInc) node = balanceRightInsert(node, heightInc);
-    } else {
-        node->indices.add(index);
-        heightInc = false;
-    }
-    return node;
-}
-
-FeedingNode* FeedingTree::deleteNode(FeedingNode* node, const std::string& key, int index, bool &heightDec) {
-    if (!node) {
-        heightDec = false;
-        return nullptr;
-    }
-    if (key < node->key) {
-        node->left = deleteNode(node->left, key, index, heightDec);
-        if (heightDec) node = balanceLeft(node, heightDec);
-    } else if (key > node->key) {
-        node->right = deleteNode(node->right, key, index, heightDec);
-        if (heightDec) node = balanceRight(node, heightDec);
-    } else {
-        if (index != -1) {
-            node->indices.removeAll(index);
-            if (node->indices.size() > 0) {
-                heightDec = false;
-                return node;
-            }
-        }
-        if (!node->left || !node->right) {
-            FeedingNode* child = node->left ? node->left : node->right;
-            delete node;
-            heightDec = true;
-            return child;
-        } else {
-            FeedingNode* pred = node->left;
-            while (pred->right) pred = pred->right;
-            node->key = pred->key;
-            node->indices = pred->indices;
-            bool decL = false;
-            node->left = deleteNode(node->left, pred->key, -1, decL);
-            if (decL) node = balanceLeft(node, heightDec);
-            else heightDec = false;
-        }
-    }
-    return node;
-}
\ No newline at end of file
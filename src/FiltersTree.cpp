@@ -1,16 +1,14 @@
 #include "FiltersTree.h"
-#include <sstream>
-#include <iomanip>
 
 template<typename T>
-FilterNode<T>::FilterNode(const T& k, int idx)
-    : key(k), balance(0), left(nullptr), right(nullptr), indices()
+FilterNode<T>::FilterNode(const T& k, int idx, long long w)
+    : key(k), balance(0), left(nullptr), right(nullptr), weight(w), subtreeCount(1), subtreeSum(w)
 {
     indices.add(idx);
 }
 
 template<typename T>
-FiltersTree<T>::FiltersTree() : root(nullptr) {}
+FiltersTree<T>::FiltersTree(MonotonicArena* arena) : root(nullptr), arena(arena), freeNodes(nullptr) {}
 
 template<typename T>
 FiltersTree<T>::~FiltersTree() {
@@ -21,6 +19,8 @@ template<typename T>
 void FiltersTree<T>::clear() {
     clearNode(root);
     root = nullptr;
+    // Освобождённые узлы лежат в арене и пропадут при её reset()
+    freeNodes = nullptr;
 }
 
 template<typename T>
@@ -28,101 +28,424 @@ void FiltersTree<T>::clearNode(FilterNode<T>* node) {
     if (!node) return;
     clearNode(node->left);
     clearNode(node->right);
-    delete node;
+    destroyNode(node);
 }
 
 template<typename T>
-void FiltersTree<T>::add(const T& filterValue, int index) {
-    bool inc = false;
-    root = insertNode(root, filterValue, index, inc);
+FilterNode<T>* FiltersTree<T>::createNode(const T& key, int index, long long weight) {
+    if (arena) {
+        if (freeNodes) {
+            void* memory = freeNodes;
+            freeNodes = *static_cast<void**>(memory);
+            return ::new (memory) FilterNode<T>(key, index, weight);
+        }
+        return arena->create<FilterNode<T>>(key, index, weight);
+    }
+    return new FilterNode<T>(key, index, weight);
+}
+
+template<typename T>
+void FiltersTree<T>::destroyNode(FilterNode<T>* node) {
+    if (arena) {
+        // Память узла уходит в список свободных и достаётся следующей вставке
+        node->~FilterNode<T>();
+        *reinterpret_cast<void**>(node) = freeNodes;
+        freeNodes = node;
+    } else {
+        delete node;
+    }
+}
+
+namespace {
+    // Трёхстороннее сравнение: одно на уровень спуска вместо пары < и >
+    template<typename T>
+    int compareKeys(const T& a, const T& b) {
+        return a < b ? -1 : (b < a ? 1 : 0);
+    }
+
+    int compareKeys(const std::string& a, const std::string& b) {
+        return a.compare(b);
+    }
+
+    int compareKeys(InternedString a, InternedString b) {
+        return a == b ? 0 : a.view().compare(b.view());
+    }
+}
+
+// Вставка и удаление без рекурсии: спуск запоминает адреса ссылок на узлы
+// пути (поле предка или root) и направление шага. Балансировка на подъёме
+// заканчивается на первом предке, чья высота не изменилась, агрегаты
+// пересчитываются по всему пути до корня
+template<typename T>
+void FiltersTree<T>::add(const T& filterValue, int index, long long weight) {
+    FilterNode<T>** path[MAX_DEPTH];
+    int dirs[MAX_DEPTH];
+    int depth = 0;
+    FilterNode<T>** link = &root;
+    while (*link) {
+        FilterNode<T>* node = *link;
+        int cmp = compareKeys(filterValue, node->key);
+        if (cmp == 0) {
+            // Повторный номер не добавляется и не меняет сумму
+            int before = node->indices.size();
+            node->indices.add(index);
+            if (node->indices.size() == before) return;
+            node->weight += weight;
+            pull(node);
+            break;
+        }
+        path[depth] = link;
+        dirs[depth++] = cmp;
+        link = cmp < 0 ? &node->left : &node->right;
+    }
+    bool heightInc = false;
+    if (!*link) {
+        *link = createNode(filterValue, index, weight);
+        heightInc = true;
+    }
+
+    while (depth > 0) {
+        --depth;
+        FilterNode<T>** at = path[depth];
+        if (heightInc) {
+            *at = dirs[depth] < 0 ? balanceLeftInsert(*at, heightInc) : balanceRightInsert(*at, heightInc);
+        }
+        pull(*at);
+    }
+}
+
+template<typename T>
+void FiltersTree<T>::remove(const T& filterValue, int index, long long weight) {
+    FilterNode<T>** path[MAX_DEPTH];
+    int dirs[MAX_DEPTH];
+    int depth = 0;
+    FilterNode<T>** link = &root;
+    while (*link) {
+        int cmp = compareKeys(filterValue, (*link)->key);
+        if (cmp == 0) break;
+        path[depth] = link;
+        dirs[depth++] = cmp;
+        link = cmp < 0 ? &(*link)->left : &(*link)->right;
+    }
+    FilterNode<T>* node = *link;
+    if (!node) return;
+    int before = node->indices.size();
+    node->indices.remove(index);
+    if (node->indices.size() == before) return;
+    node->weight -= weight;
+
+    bool heightDec = false;
+    if (node->indices.size() > 0) {
+        pull(node);
+    } else {
+        if (node->left && node->right) {
+            // Ключ, список и вес предшественника переезжают в узел, удаляется сам предшественник
+            path[depth] = link;
+            dirs[depth++] = -1;
+            link = &node->left;
+            while ((*link)->right) {
+                path[depth] = link;
+                dirs[depth++] = 1;
+                link = &(*link)->right;
+            }
+            FilterNode<T>* pred = *link;
+            node->key = pred->key;
+            node->indices.swap(pred->indices);
+            node->weight = pred->weight;
+            node = pred;
+        }
+        *link = node->left ? node->left : node->right;
+        destroyNode(node);
+        heightDec = true;
+    }
+
+    while (depth > 0) {
+        --depth;
+        FilterNode<T>** at = path[depth];
+        if (heightDec) {
+            *at = dirs[depth] < 0 ? balanceLeft(*at, heightDec) : balanceRight(*at, heightDec);
+        }
+        pull(*at);
+    }
 }
 
 template<typename T>
-void FiltersTree<T>::remove(const T& filterValue, int index) {
-    bool dec = false;
-    root = deleteNode(root, filterValue, index, dec);
+void FiltersTree<T>::buildFromSorted(const BuildEntry* entries, size_t count) {
+    clear();
+    DynamicArray<size_t> groupStarts;
+    for (size_t i = 0; i < count; ++i) {
+        if (i == 0 || entries[i - 1].key < entries[i].key) {
+            groupStarts.push_back(i);
+        }
+    }
+    groupStarts.push_back(count);
+    int height;
+    root = buildRange(entries, groupStarts.data(), 0, groupStarts.size() - 1, height);
 }
 
 template<typename T>
-CircularList FiltersTree<T>::search(const T& filterValue) const {
+FilterNode<T>* FiltersTree<T>::buildRange(const BuildEntry* entries, const size_t* groupStarts,
+                                          size_t lo, size_t hi, int &height) {
+    if (lo >= hi) {
+        height = 0;
+        return nullptr;
+    }
+    // Середина уходит в корень. Из n = hi - lo групп (полуинтервал) слева
+    // остаётся n / 2, справа n - n / 2 - 1: при чётном n левая половина на одну
+    // группу больше, при нечётном половины равны. Высоты поддеревьев поэтому
+    // отличаются не больше чем на 1
+    size_t mid = lo + (hi - lo) / 2;
+    int leftHeight, rightHeight;
+    // Левое поддерево создаётся первым: с ареной узлы лежат в порядке ключей
+    FilterNode<T>* left = buildRange(entries, groupStarts, lo, mid, leftHeight);
+
+    const BuildEntry& first = entries[groupStarts[mid]];
+    FilterNode<T>* node = createNode(first.key, first.index, first.weight);
+    for (size_t i = groupStarts[mid] + 1; i < groupStarts[mid + 1]; ++i) {
+        int before = node->indices.size();
+        node->indices.add(entries[i].index);
+        if (node->indices.size() != before) {
+            node->weight += entries[i].weight;
+        }
+    }
+
+    node->left = left;
+    node->right = buildRange(entries, groupStarts, mid + 1, hi, rightHeight);
+    node->balance = rightHeight - leftHeight;
+    height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+    pull(node);
+    return node;
+}
+
+template<typename T>
+void FiltersTree<T>::pull(FilterNode<T>* node) {
+    node->subtreeCount = node->indices.size();
+    node->subtreeSum = node->weight;
+    if (node->left) {
+        node->subtreeCount += node->left->subtreeCount;
+        node->subtreeSum += node->left->subtreeSum;
+    }
+    if (node->right) {
+        node->subtreeCount += node->right->subtreeCount;
+        node->subtreeSum += node->right->subtreeSum;
+    }
+}
+
+template<typename T>
+void FiltersTree<T>::prefixAggregate(ProbeKey bound, bool inclusive, int &count, long long &sum) const {
+    count = 0;
+    sum = 0;
     FilterNode<T>* cur = root;
     while (cur) {
-        if (filterValue < cur->key) {
+        if (cur->key < bound || (inclusive && !(bound < cur->key))) {
+            // Узел и всё его левое поддерево левее границы
+            count += cur->indices.size();
+            sum += cur->weight;
+            if (cur->left) {
+                count += cur->left->subtreeCount;
+                sum += cur->left->subtreeSum;
+            }
+            cur = cur->right;
+        } else {
             cur = cur->left;
-        } else if (filterValue > cur->key) {
+        }
+    }
+}
+
+template<typename T>
+int FiltersTree<T>::countInRange(KeyView minValue, KeyView maxValue) const {
+    ProbeKey minKey = FilterKeyView<T>::probe(minValue);
+    ProbeKey maxKey = FilterKeyView<T>::probe(maxValue);
+    if (maxKey < minKey) return 0;
+    int below, upTo;
+    long long sumBelow, sumUpTo;
+    prefixAggregate(minKey, false, below, sumBelow);
+    prefixAggregate(maxKey, true, upTo, sumUpTo);
+    return upTo - below;
+}
+
+template<typename T>
+long long FiltersTree<T>::sumInRange(KeyView minValue, KeyView maxValue) const {
+    ProbeKey minKey = FilterKeyView<T>::probe(minValue);
+    ProbeKey maxKey = FilterKeyView<T>::probe(maxValue);
+    if (maxKey < minKey) return 0;
+    int below, upTo;
+    long long sumBelow, sumUpTo;
+    prefixAggregate(minKey, false, below, sumBelow);
+    prefixAggregate(maxKey, true, upTo, sumUpTo);
+    return sumUpTo - sumBelow;
+}
+
+template<typename T>
+const PostingList* FiltersTree<T>::findPostings(KeyView filterValue) const {
+    ProbeKey key = FilterKeyView<T>::probe(filterValue);
+    FilterNode<T>* cur = root;
+    while (cur) {
+        if (key < cur->key) {
+            cur = cur->left;
+        } else if (key > cur->key) {
             cur = cur->right;
         } else {
-            return cur->indices;
+            return &cur->indices;
         }
     }
-    return CircularList();
+    return nullptr;
+}
+
+template<typename T>
+PostingsView<PostingList> FiltersTree<T>::search(KeyView filterValue) const {
+    const PostingList* postings = findPostings(filterValue);
+    return postings ? PostingsView<PostingList>(*postings) : PostingsView<PostingList>();
 }
 
 template<typename T>
-CircularList FiltersTree<T>::searchInRange(const T& minValue, const T& maxValue) const {
-    CircularList result;
-    rangeSearch(root, minValue, maxValue, result);
+PostingsView<PostingList> FiltersTree<T>::searchInRange(KeyView minValue, KeyView maxValue) const {
+    PostingsView<PostingList> result;
+    rangeSearch(root, FilterKeyView<T>::probe(minValue), FilterKeyView<T>::probe(maxValue), result);
     return result;
 }
 
 template<typename T>
-CircularList FiltersTree<T>::getAllIndices() const {
-    CircularList result;
+PostingsView<PostingList> FiltersTree<T>::getAllIndices() const {
+    PostingsView<PostingList> result;
     inOrderCollect(root, result);
     return result;
 }
 
 template<typename T>
-void FiltersTree<T>::print(std::ostream &out) const {
+int FiltersTree<T>::rank(KeyView filterValue) const {
+    int count;
+    long long sum;
+    prefixAggregate(FilterKeyView<T>::probe(filterValue), false, count, sum);
+    return count;
+}
+
+template<typename T>
+int FiltersTree<T>::select(int position) const {
+    DynamicArray<int> one;
+    collectFrom(position, 1, one);
+    return one.empty() ? -1 : one[0];
+}
+
+template<typename T>
+void FiltersTree<T>::page(int offset, int limit, DynamicArray<int> &out) const {
+    if (offset < 0) offset = 0;
+    int count = size() - offset;
+    if (limit < count) count = limit;
+    collectFrom(offset, count, out);
+}
+
+template<typename T>
+void FiltersTree<T>::rangePage(KeyView minValue, KeyView maxValue, int offset, int limit, DynamicArray<int> &out) const {
+    ProbeKey minKey = FilterKeyView<T>::probe(minValue);
+    ProbeKey maxKey = FilterKeyView<T>::probe(maxValue);
+    if (maxKey < minKey) return;
+    if (offset < 0) offset = 0;
+    int first, last;
+    long long sum;
+    prefixAggregate(minKey, false, first, sum);
+    prefixAggregate(maxKey, true, last, sum);
+    int count = last - first - offset;
+    if (limit < count) count = limit;
+    collectFrom(first + offset, count, out);
+}
+
+template<typename T>
+void FiltersTree<T>::collectFrom(int position, int count, DynamicArray<int> &out) const {
+    if (count <= 0 || position < 0) return;
+
+    // Спуск к узлу с позицией position; предки, от которых ушли влево, - в стек
+    FilterNode<T>* stack[MAX_DEPTH];
+    int depth = 0;
+    FilterNode<T>* cur = root;
+    while (cur) {
+        int leftCount = cur->left ? cur->left->subtreeCount : 0;
+        if (position < leftCount) {
+            stack[depth++] = cur;
+            cur = cur->left;
+        } else if (position < leftCount + cur->indices.size()) {
+            position -= leftCount;
+            break;
+        } else {
+            position -= leftCount + cur->indices.size();
+            cur = cur->right;
+        }
+    }
+    if (!cur) return;
+
+    PostingList::const_iterator it = cur->indices.iteratorAt(position);
+    while (true) {
+        for (PostingList::const_iterator end = cur->indices.end(); it != end && count > 0; ++it, --count) {
+            out.push_back(*it);
+        }
+        if (count == 0) return;
+        // Следующий узел по порядку: самый левый в правом поддереве или ближайший предок из стека
+        if (cur->right) {
+            cur = cur->right;
+            while (cur->left) {
+                stack[depth++] = cur;
+                cur = cur->left;
+            }
+        } else if (depth > 0) {
+            cur = stack[--depth];
+        } else {
+            return;
+        }
+        it = cur->indices.begin();
+    }
+}
+
+template<typename T>
+void FiltersTree<T>::print(std::ostream &out, KeyFormatter formatKey) const {
     if (!root) {
         out << "[Empty filter tree]" << std::endl;
         return;
     }
     out << "Структура дерева:\n";
-    prettyPrint(root, out, "", true, 1);
+    prettyPrint(root, out, "", true, 1, formatKey);
 }
 
 template<typename T>
-void FiltersTree<T>::prettyPrint(FilterNode<T>* node, std::ostream &out, const std::string& prefix, bool isLast, int level) const {
+void FiltersTree<T>::prettyPrint(FilterNode<T>* node, std::ostream &out, const std::string& prefix, bool isLast, int level,
+                                 KeyFormatter formatKey) const {
     if (!node) return;
     if (node->right) {
-        prettyPrint(node->right, out, prefix + "        ", false, level + 1);
+        prettyPrint(node->right, out, prefix + "        ", false, level + 1, formatKey);
     }
-    out << prefix << std::string(level, '<') << node->key << "\n";
+    out << prefix << std::string(level, '<');
+    if (formatKey) {
+        out << formatKey(node->key);
+    } else {
+        out << node->key;
+    }
+    out << "\n";
     if (node->left) {
-        prettyPrint(node->left, out, prefix + "        ", true, level + 1);
+        prettyPrint(node->left, out, prefix + "        ", true, level + 1, formatKey);
     }
 }
 
 template<typename T>
-void FiltersTree<T>::inOrderCollect(FilterNode<T>* node, CircularList &result) const {
+void FiltersTree<T>::inOrderCollect(FilterNode<T>* node, PostingsView<PostingList> &result) const {
     if (!node) return;
 
     inOrderCollect(node->left, result);
-
-    for (int i = 0; i < node->indices.size(); ++i) {
-        result.add(node->indices.get(i));
-    }
-
+    result.append(node->indices);
     inOrderCollect(node->right, result);
 }
 
 template<typename T>
-void FiltersTree<T>::rangeSearch(FilterNode<T>* node, const T& minVal, const T& maxVal, CircularList &result) const {
+void FiltersTree<T>::rangeSearch(FilterNode<T>* node, ProbeKey minVal, ProbeKey maxVal, PostingsView<PostingList> &result) const {
     if (!node) return;
 
-    if (node->key > maxVal) {
+    // Симметричный обход с отсечением: поддеревья целиком вне диапазона
+    // не посещаются, а номера попадают в результат в порядке ключей
+    if (node->key > minVal) {
         rangeSearch(node->left, minVal, maxVal, result);
     }
-    else if (node->key < minVal) {
-        rangeSearch(node->right, minVal, maxVal, result);
+    if (!(node->key < minVal) && !(node->key > maxVal)) {
+        result.append(node->indices);
     }
-    else {
-        for (int i = 0; i < node->indices.size(); ++i) {
-            result.add(node->indices.get(i));
-        }
-
-        rangeSearch(node->left, minVal, maxVal, result);
+    if (node->key < maxVal) {
         rangeSearch(node->right, minVal, maxVal, result);
     }
 }
@@ -132,6 +455,8 @@ FilterNode<T>* FiltersTree<T>::rotateLeft(FilterNode<T>* a) {
     FilterNode<T>* b = a->right;
     a->right = b->left;
     b->left = a;
+    pull(a);
+    pull(b);
 
     if (b->balance == 0) {
         a->balance = 1;
@@ -148,6 +473,8 @@ FilterNode<T>* FiltersTree<T>::rotateRight(FilterNode<T>* a) {
     FilterNode<T>* b = a->left;
     a->left = b->right;
     b->right = a;
+    pull(a);
+    pull(b);
 
     if (b->balance == 0) {
         a->balance = -1;
@@ -169,6 +496,8 @@ FilterNode<T>* FiltersTree<T>::balanceLeft(FilterNode<T>* node, bool &heightDec)
     } else {
         FilterNode<T>* r = node->right;
         if (r->balance >= 0) {
+            // При сбалансированном r высота после поворота не меняется
+            if (r->balance == 0) heightDec = false;
             node = rotateLeft(node);
         } else {
             int oldBalance = r->left->balance;
@@ -201,6 +530,7 @@ FilterNode<T>* FiltersTree<T>::balanceRight(FilterNode<T>* node, bool &heightDec
     } else {
         FilterNode<T>* l = node->left;
         if (l->balance <= 0) {
+            if (l->balance == 0) heightDec = false;
             node = rotateRight(node);
         } else {
             int oldBalance = l->right->balance;
@@ -211,11 +541,11 @@ FilterNode<T>* FiltersTree<T>::balanceRight(FilterNode<T>* node, bool &heightDec
                 node->left->balance = 0;
                 node->right->balance = 0;
             } else if (oldBalance == -1) {
-                node->left->balance = -1;
-                node->right->balance = 0;
-            } else {
                 node->left->balance = 0;
                 node->right->balance = 1;
+            } else {
+                node->left->balance = -1;
+                node->right->balance = 0;
             }
             node->balance = 0;
         }
@@ -224,124 +554,65 @@ FilterNode<T>* FiltersTree<T>::balanceRight(FilterNode<T>* node, bool &heightDec
 }
 
 template<typename T>
-FilterNode<T>* FiltersTree<T>::insertNode(FilterNode<T>* node, const T& key, int index, bool &heightInc) {
-    if (!node) {
-        heightInc = true;
-        return new FilterNode<T>(key, index);
-    }
+FilterNode<T>* FiltersTree<T>::balanceLeftInsert(FilterNode<T>* node, bool &heightInc) {
+    if (node->balance == 1) {
+        node->balance = 0;
+        heightInc = false;
+    } else if (node->balance == 0) {
+        node->balance = -1;
+    } else {
+        if (node->left->balance <= 0) {
+            node = rotateRight(node);
+        } else {
+            int oldBalance = node->left->right->balance;
+            node->left = rotateLeft(node->left);
+            node = rotateRight(node);
 
-    if (key < node->key) {
-        node->left = insertNode(node->left, key, index, heightInc);
-        if (heightInc) {
-            if (node->balance == 1) {
-                node->balance = 0;
-                heightInc = false;
-            } else if (node->balance == 0) {
-                node->balance = -1;
-            } else {
-                if (node->left->balance <= 0) {
-                    node = rotateRight(node);
-                } else {
-                    int oldBalance = node->left->right->balance;
-                    node->left = rotateLeft(node->left);
-                    node = rotateRight(node);
-
-                    if (oldBalance == 0) {
-                        node->left->balance = 0;
-                        node->right->balance = 0;
-                    } else if (oldBalance == -1) {
-                        node->left->balance = -1;
-                        node->right->balance = 0;
-                    } else {
-                        node->left->balance = 0;
-                        node->right->balance = 1;
-                    }
-                    node->balance = 0;
-                }
-                heightInc = false;
-            }
-        }
-    } else if (key > node->key) {
-        node->right = insertNode(node->right, key, index, heightInc);
-        if (heightInc) {
-            if (node->balance == -1) {
-                node->balance = 0;
-                heightInc = false;
-            } else if (node->balance == 0) {
-                node->balance = 1;
+            if (oldBalance == 0) {
+                node->left->balance = 0;
+                node->right->balance = 0;
+            } else if (oldBalance == -1) {
+                node->left->balance = 0;
+                node->right->balance = 1;
             } else {
-                if (node->right->balance >= 0) {
-                    node = rotateLeft(node);
-                } else {
-                    int oldBalance = node->right->left->balance;
-                    node->right = rotateRight(node->right);
-                    node = rotateLeft(node);
-
-                    if (oldBalance == 0) {
-                        node->left->balance = 0;
-                        node->right->balance = 0;
-                    } else if (oldBalance == -1) {
-                        node->left->balance = 0;
-                        node->right->balance = 1;
-                    } else {
-                        node->left->balance = -1;
-                        node->right->balance = 0;
-                    }
-                    node->balance = 0;
-                }
-                heightInc = false;
+                node->left->balance = -1;
+                node->right->balance = 0;
             }
+            node->balance = 0;
         }
-    } else {
-        node->indices.add(index);
         heightInc = false;
     }
     return node;
 }
 
 template<typename T>
-FilterNode<T>* FiltersTree<T>::deleteNode(FilterNode<T>* node, const T& key, int index, bool &heightDec) {
-    if (!node) {
-        heightDec = false;
-        return nullptr;
-    }
-
-    if (key < node->key) {
-        node->left = deleteNode(node->left, key, index, heightDec);
-        if (heightDec)
-            node = balanceLeft(node, heightDec);
-    } else if (key > node->key) {
-        node->right = deleteNode(node->right, key, index, heightDec);
-        if (heightDec)
-            node = balanceRight(node, heightDec);
+FilterNode<T>* FiltersTree<T>::balanceRightInsert(FilterNode<T>* node, bool &heightInc) {
+    if (node->balance == -1) {
+        node->balance = 0;
+        heightInc = false;
+    } else if (node->balance == 0) {
+        node->balance = 1;
     } else {
-        if (index != -1) {
-            node->indices.removeAll(index);
-            if (node->indices.size() > 0) {
-                heightDec = false;
-                return node;
-            }
-        }
-
-        if (!node->left || !node->right) {
-            FilterNode<T>* child = node->left ? node->left : node->right;
-            delete node;
-            heightDec = true;
-            return child;
+        if (node->right->balance >= 0) {
+            node = rotateLeft(node);
         } else {
-            FilterNode<T>* pred = node->left;
-            while (pred->right) pred = pred->right;
+            int oldBalance = node->right->left->balance;
+            node->right = rotateRight(node->right);
+            node = rotateLeft(node);
 
-            node->key = pred->key;
-            node->indices = pred->indices;
-
-            bool decL = false;
-            node->left = deleteNode(node->left, pred->key, -1, decL);
-            if (decL)
-                node = balanceLeft(node, heightDec);
-            else
-                heightDec = false;
+            if (oldBalance == 0) {
+                node->left->balance = 0;
+                node->right->balance = 0;
+            } else if (oldBalance == -1) {
+                node->left->balance = 0;
+                node->right->balance = 1;
+            } else {
+                node->left->balance = -1;
+                node->right->balance = 0;
+            }
+            node->balance = 0;
         }
+        heightInc = false;
     }
     return node;
 }
@@ -349,47 +620,8 @@ FilterNode<T>* FiltersTree<T>::deleteNode(FilterNode<T>* node, const T& key, int
 template class FiltersTree<double>;
 template class FiltersTree<int>;
 template class FiltersTree<std::string>;
+template class FiltersTree<InternedString>;
 template class FilterNode<double>;
 template class FilterNode<int>;
 template class FilterNode<std::string>;
-
-namespace DateUtils {
-    std::string normalizeDateForComparison(const std::string& date) {
-        if (date.length() != 10 || date[2] != '.' || date[5] != '.') {
-            return "";
-        }
-
-        try {
-            int day = std::stoi(date.substr(0, 2));
-            int month = std::stoi(date.substr(3, 2));
-            int year = std::stoi(date.substr(6, 4));
-
-            if (day < 1 || day > 31 || month < 1 || month > 12 || year < 2000 || year > 2025) {
-                return "";
-            }
-
-            std::ostringstream oss;
-            oss << year << "-" << std::setfill('0') << std::setw(2) << month << "-" << std::setw(2) << day;
-            return oss.str();
-        } catch (...) {
-            return "";
-        }
-    }
-
-    bool isValidDateFormat(const std::string& date) {
-        return !normalizeDateForComparison(date).empty();
-    }
-
-    int compareDates(const std::string& date1, const std::string& date2) {
-        std::string norm1 = normalizeDateForComparison(date1);
-        std::string norm2 = normalizeDateForComparison(date2);
-
-        if (norm1.empty() || norm2.empty()) {
-            return 0;
-        }
-
-        if (norm1 < norm2) return -1;
-        if (norm1 > norm2) return 1;
-        return 0;
-    }
-}
\ No newline at end of file
+template class FilterNode<InternedString>;
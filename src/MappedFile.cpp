@@ -0,0 +1,117 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile()
+    : bytes(nullptr), length(0), opened(false), fileHandle(nullptr), mappingHandle(nullptr) {}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    length = static_cast<size_t>(fileSize.QuadPart);
+    opened = true;
+    // Пустой файл отобразить нельзя, но открыть его - не ошибка
+    if (length == 0) {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        close();
+        return false;
+    }
+    mappingHandle = mapping;
+
+    bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!bytes) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close() {
+    if (bytes) UnmapViewOfFile(bytes);
+    if (mappingHandle) CloseHandle(static_cast<HANDLE>(mappingHandle));
+    if (fileHandle) CloseHandle(static_cast<HANDLE>(fileHandle));
+    bytes = nullptr;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+    length = 0;
+    opened = false;
+}
+
+#else
+
+MappedFile::MappedFile() : bytes(nullptr), length(0), opened(false), fd(-1) {}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close();
+        return false;
+    }
+
+    length = static_cast<size_t>(info.st_size);
+    opened = true;
+    // Пустой файл отобразить нельзя, но открыть его - не ошибка
+    if (length == 0) {
+        return true;
+    }
+
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+        close();
+        return false;
+    }
+    madvise(mapped, length, MADV_SEQUENTIAL);
+    bytes = static_cast<const char*>(mapped);
+    return true;
+}
+
+void MappedFile::close() {
+    if (bytes) munmap(const_cast<char*>(bytes), length);
+    if (fd >= 0) ::close(fd);
+    bytes = nullptr;
+    fd = -1;
+    length = 0;
+    opened = false;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
@@ -0,0 +1,259 @@
+#include "PostingList.h"
+#include <algorithm>
+#include <utility>
+
+void PostingList::appendVarint(DynamicArray<uint8_t>& bytes, uint32_t value) {
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<uint8_t>(value));
+}
+
+uint32_t PostingList::readVarint(const DynamicArray<uint8_t>& bytes, size_t& offset) {
+    uint32_t value = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+        byte = bytes[offset++];
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+int PostingList::decode(const Block& block, int* out) {
+    out[0] = block.first;
+    size_t offset = 0;
+    for (int i = 1; i < block.count; ++i) {
+        out[i] = out[i - 1] + static_cast<int>(readVarint(block.deltas, offset));
+    }
+    return block.count;
+}
+
+void PostingList::encode(Block& block, const int* ids, int count) {
+    block.first = ids[0];
+    block.last = ids[count - 1];
+    block.count = count;
+    block.deltas.clear();
+    for (int i = 1; i < count; ++i) {
+        appendVarint(block.deltas, static_cast<uint32_t>(ids[i] - ids[i - 1]));
+    }
+}
+
+size_t PostingList::findBlock(int id) const {
+    size_t lo = 0, hi = blocks.size();
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (blocks[mid].first <= id) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void PostingList::add(int id) {
+    if (blocks.empty()) {
+        // Большинство ключей с одной записью: не держим лишней ёмкости
+        blocks.reserve(1);
+        blocks.emplace_back();
+        blocks[0].first = blocks[0].last = id;
+        blocks[0].count = 1;
+        total = 1;
+        return;
+    }
+
+    size_t b = findBlock(id);
+    Block& block = blocks[b];
+    if (id > block.last) {
+        // Частый случай - номер больше всех в блоке: дописываем разность
+        if (block.count < BLOCK_SIZE) {
+            appendVarint(block.deltas, static_cast<uint32_t>(id - block.last));
+            block.last = id;
+            block.count++;
+            total++;
+            return;
+        }
+        if (b + 1 == blocks.size()) {
+            Block fresh;
+            fresh.first = fresh.last = id;
+            fresh.count = 1;
+            blocks.push_back(std::move(fresh));
+            total++;
+            return;
+        }
+    }
+
+    int ids[BLOCK_SIZE + 1];
+    int count = decode(block, ids);
+    int* place = std::lower_bound(ids, ids + count, id);
+    if (place != ids + count && *place == id) {
+        return;
+    }
+    std::move_backward(place, ids + count, ids + count + 1);
+    *place = id;
+    count++;
+    total++;
+
+    if (count <= BLOCK_SIZE) {
+        encode(block, ids, count);
+        return;
+    }
+    // Переполненный блок делится пополам; новый блок вставляется за ним
+    int half = count / 2;
+    encode(block, ids, half);
+    Block tail;
+    encode(tail, ids + half, count - half);
+    blocks.push_back(Block());
+    for (size_t i = blocks.size() - 1; i > b + 1; --i) {
+        blocks[i] = std::move(blocks[i - 1]);
+    }
+    blocks[b + 1] = std::move(tail);
+}
+
+void PostingList::remove(int id) {
+    if (blocks.empty()) return;
+    size_t b = findBlock(id);
+    Block& block = blocks[b];
+    if (id < block.first || id > block.last) return;
+
+    int ids[BLOCK_SIZE];
+    int count = decode(block, ids);
+    int* place = std::lower_bound(ids, ids + count, id);
+    if (place == ids + count || *place != id) return;
+    std::move(place + 1, ids + count, place);
+    count--;
+    total--;
+
+    if (count == 0) {
+        blocks.erase(b);
+    } else {
+        encode(block, ids, count);
+    }
+}
+
+bool PostingList::contains(int id) const {
+    if (blocks.empty()) return false;
+    const Block& block = blocks[findBlock(id)];
+    if (id < block.first || id > block.last) return false;
+    int value = block.first;
+    size_t offset = 0;
+    for (int i = 1; i < block.count && value < id; ++i) {
+        value += static_cast<int>(readVarint(block.deltas, offset));
+    }
+    return value == id;
+}
+
+void PostingList::clear() {
+    blocks.clear();
+    blocks.shrink_to_fit();
+    total = 0;
+}
+
+void PostingList::swap(PostingList& other) noexcept {
+    std::swap(blocks, other.blocks);
+    std::swap(total, other.total);
+}
+
+size_t PostingList::getBytesUsed() const {
+    size_t bytes = blocks.capacity() * sizeof(Block);
+    for (const Block& block : blocks) {
+        bytes += block.deltas.capacity();
+    }
+    return bytes;
+}
+
+PostingList::const_iterator PostingList::begin() const {
+    const_iterator it;
+    it.list = this;
+    if (!blocks.empty()) {
+        it.value = blocks[0].first;
+    }
+    return it;
+}
+
+PostingList::const_iterator PostingList::end() const {
+    const_iterator it;
+    it.list = this;
+    it.block = blocks.size();
+    it.pos = total;
+    return it;
+}
+
+PostingList::const_iterator PostingList::iteratorAt(int position) const {
+    if (position <= 0) return begin();
+    if (position >= total) return end();
+    size_t b = 0;
+    int skipped = 0;
+    while (skipped + blocks[b].count <= position) {
+        skipped += blocks[b].count;
+        ++b;
+    }
+    const_iterator it;
+    it.list = this;
+    it.block = b;
+    it.value = blocks[b].first;
+    it.pos = position;
+    for (int i = skipped; i < position; ++i) {
+        it.inBlock++;
+        it.value += static_cast<int>(readVarint(blocks[b].deltas, it.offset));
+    }
+    return it;
+}
+
+PostingList::const_iterator& PostingList::const_iterator::operator++() {
+    ++pos;
+    const Block& current = list->blocks[block];
+    if (++inBlock < current.count) {
+        value += static_cast<int>(readVarint(current.deltas, offset));
+        return *this;
+    }
+    ++block;
+    inBlock = 0;
+    offset = 0;
+    if (block < list->blocks.size()) {
+        value = list->blocks[block].first;
+    }
+    return *this;
+}
+
+void PostingList::intersect(const PostingList& a, const PostingList& b, DynamicArray<int>& out) {
+    int idsA[BLOCK_SIZE], idsB[BLOCK_SIZE];
+    int countA = 0, countB = 0;
+    size_t decodedA = a.blocks.size(), decodedB = b.blocks.size();
+
+    size_t i = 0, j = 0;
+    while (i < a.blocks.size() && j < b.blocks.size()) {
+        const Block& x = a.blocks[i];
+        const Block& y = b.blocks[j];
+        // Непересекающиеся диапазоны пропускаются без распаковки
+        if (x.last < y.first) { ++i; continue; }
+        if (y.last < x.first) { ++j; continue; }
+
+        if (decodedA != i) { countA = decode(x, idsA); decodedA = i; }
+        if (decodedB != j) { countB = decode(y, idsB); decodedB = j; }
+        int p = 0, q = 0;
+        while (p < countA && q < countB) {
+            if (idsA[p] < idsB[q]) {
+                ++p;
+            } else if (idsB[q] < idsA[p]) {
+                ++q;
+            } else {
+                out.push_back(idsA[p]);
+                ++p;
+                ++q;
+            }
+        }
+
+        if (x.last < y.last) {
+            ++i;
+        } else if (y.last < x.last) {
+            ++j;
+        } else {
+            ++i;
+            ++j;
+        }
+    }
+}
@@ -0,0 +1,243 @@
+#include "Snapshot.h"
+#include "MappedFile.h"
+#include "StringPool.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace {
+    const char MAGIC[8] = { 'Z', 'O', 'O', 'S', 'N', 'A', 'P', '\0' };
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t stringCount;
+        uint64_t stringBytes;
+        uint64_t animalCount;
+        uint64_t animalSlots;
+        uint64_t feedingCount;
+        uint64_t feedingSlots;
+    };
+
+    static_assert(std::is_trivially_copyable<Animal>::value, "Animal must be trivially copyable");
+    static_assert(std::is_trivially_copyable<FeedingEntry>::value, "FeedingEntry must be trivially copyable");
+
+    template<typename T>
+    void writeRaw(std::ostream& out, const T* data, size_t count) {
+        if (count > 0) {
+            out.write(reinterpret_cast<const char*>(data), sizeof(T) * count);
+        }
+    }
+
+    bool readRaw(const char*& cursor, const char* end, void* dest, size_t bytes) {
+        if (static_cast<size_t>(end - cursor) < bytes) {
+            return false;
+        }
+        if (bytes > 0) {
+            std::memcpy(dest, cursor, bytes);
+        }
+        cursor += bytes;
+        return true;
+    }
+
+    // Записи по порядку хранения, их id и поколения всех слотов
+    template<typename T>
+    void writeRecords(std::ostream& out, const SlotMap<T>& records) {
+        if (!records.empty()) {
+            writeRaw(out, &records.denseValues()[0], records.size());
+            writeRaw(out, &records.denseIds()[0], records.size());
+        }
+        for (int id = 0; id < records.slotCount(); ++id) {
+            uint32_t generation = records.generationOf(id);
+            writeRaw(out, &generation, 1);
+        }
+    }
+
+    // Обратное writeRecords; fixup переводит id строк записи и может её отвергнуть
+    template<typename T, typename Fixup>
+    bool readRecords(const char*& cursor, const char* end, uint64_t count, uint64_t slotCount,
+                     SlotMap<T>& records, Fixup fixup) {
+        if (count > slotCount || slotCount > static_cast<uint64_t>(INT32_MAX) ||
+            static_cast<uint64_t>(end - cursor) / (sizeof(T) + sizeof(int)) < count) {
+            return false;
+        }
+        DynamicArray<T> values;
+        values.reserve(count);
+        for (uint64_t i = 0; i < count; ++i) {
+            T record;
+            if (!readRaw(cursor, end, &record, sizeof(record)) || !fixup(record)) {
+                return false;
+            }
+            values.push_back(record);
+        }
+        DynamicArray<int> ids;
+        ids.reserve(count);
+        for (uint64_t i = 0; i < count; ++i) {
+            int id;
+            if (!readRaw(cursor, end, &id, sizeof(id))) {
+                return false;
+            }
+            ids.push_back(id);
+        }
+        if (static_cast<uint64_t>(end - cursor) / sizeof(uint32_t) < slotCount) {
+            return false;
+        }
+        DynamicArray<uint32_t> generations;
+        generations.reserve(slotCount);
+        for (uint64_t i = 0; i < slotCount; ++i) {
+            uint32_t generation;
+            if (!readRaw(cursor, end, &generation, sizeof(generation))) {
+                return false;
+            }
+            generations.push_back(generation);
+        }
+        return records.restore(std::move(values), std::move(ids), generations);
+    }
+
+    // Ложь - id строки вне таблицы строк файла
+    bool validId(InternedString value, uint32_t stringCount) {
+        return value.getId() < stringCount;
+    }
+
+    void remapId(InternedString& value, const DynamicArray<uint32_t>& remap) {
+        value = InternedString::fromId(remap[value.getId()]);
+    }
+}
+
+namespace Snapshot {
+    bool save(const std::string& filename,
+              const SlotMap<Animal>& animals,
+              const SlotMap<FeedingEntry>& feedings,
+              AnimalHashTable& animalTable) {
+        std::ofstream out(filename, std::ios::binary);
+        if (!out.is_open()) {
+            return false;
+        }
+
+        const StringPool& pool = StringPool::global();
+        Header header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.stringCount = static_cast<uint32_t>(pool.size());
+        header.stringBytes = 0;
+        for (uint32_t id = 0; id < header.stringCount; ++id) {
+            header.stringBytes += pool.view(id).length();
+        }
+        header.animalCount = animals.size();
+        header.animalSlots = static_cast<uint64_t>(animals.slotCount());
+        header.feedingCount = feedings.size();
+        header.feedingSlots = static_cast<uint64_t>(feedings.slotCount());
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        for (uint32_t id = 0; id < header.stringCount; ++id) {
+            uint32_t length = static_cast<uint32_t>(pool.view(id).length());
+            out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        }
+        for (uint32_t id = 0; id < header.stringCount; ++id) {
+            std::string_view text = pool.view(id);
+            out.write(text.data(), text.length());
+        }
+
+        writeRecords(out, animals);
+        writeRecords(out, feedings);
+        animalTable.saveSlots(out);
+
+        return static_cast<bool>(out);
+    }
+
+    bool load(const std::string& filename,
+              SlotMap<Animal>& animals,
+              SlotMap<FeedingEntry>& feedings,
+              AnimalHashTable& animalTable) {
+        MappedFile file;
+        if (!file.open(filename)) {
+            return false;
+        }
+        const char* cursor = file.data();
+        const char* end = cursor + file.size();
+
+        Header header;
+        if (!readRaw(cursor, end, &header, sizeof(header)) ||
+            std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            header.version != VERSION) {
+            return false;
+        }
+
+        // Сначала проверяется весь файл: длины строк, записи и слоты. Строки
+        // добавляются в общий пул только потом, чтобы отвергнутый снимок не
+        // оставлял в нём своих строк
+        size_t lengthBytes = sizeof(uint32_t) * static_cast<size_t>(header.stringCount);
+        if (static_cast<size_t>(end - cursor) < lengthBytes ||
+            static_cast<uint64_t>(end - cursor - lengthBytes) < header.stringBytes) {
+            return false;
+        }
+        const char* lengths = cursor;
+        const char* text = cursor + lengthBytes;
+        uint64_t totalLength = 0;
+        for (uint32_t id = 0; id < header.stringCount; ++id) {
+            uint32_t length;
+            std::memcpy(&length, lengths + sizeof(uint32_t) * id, sizeof(length));
+            totalLength += length;
+        }
+        if (totalLength != header.stringBytes) {
+            return false;
+        }
+        cursor = text + header.stringBytes;
+
+        uint32_t stringCount = header.stringCount;
+        SlotMap<Animal> loadedAnimals;
+        if (!readRecords(cursor, end, header.animalCount, header.animalSlots, loadedAnimals,
+                         [&](Animal& animal) {
+                             return validId(animal.nickname, stringCount) &&
+                                    validId(animal.species, stringCount) &&
+                                    validId(animal.cage, stringCount);
+                         })) {
+            return false;
+        }
+
+        SlotMap<FeedingEntry> loadedFeedings;
+        if (!readRecords(cursor, end, header.feedingCount, header.feedingSlots, loadedFeedings,
+                         [&](FeedingEntry& entry) {
+                             return validId(entry.nickname, stringCount) &&
+                                    validId(entry.feedType, stringCount);
+                         })) {
+            return false;
+        }
+
+        if (!animalTable.loadSlots(cursor, end, stringCount, loadedAnimals)) {
+            return false;
+        }
+
+        // Если пул был пуст, id совпадают и записи не требуют перевода
+        DynamicArray<uint32_t> remap;
+        remap.reserve(stringCount);
+        bool identity = true;
+        for (uint32_t id = 0; id < stringCount; ++id) {
+            uint32_t length;
+            std::memcpy(&length, lengths + sizeof(uint32_t) * id, sizeof(length));
+            uint32_t poolId = StringPool::global().intern(std::string_view(text, length));
+            remap.push_back(poolId);
+            identity = identity && poolId == id;
+            text += length;
+        }
+        if (!identity) {
+            for (size_t i = 0; i < loadedAnimals.size(); ++i) {
+                Animal& animal = loadedAnimals.valueAt(i);
+                remapId(animal.nickname, remap);
+                remapId(animal.species, remap);
+                remapId(animal.cage, remap);
+            }
+            for (size_t i = 0; i < loadedFeedings.size(); ++i) {
+                FeedingEntry& entry = loadedFeedings.valueAt(i);
+                remapId(entry.nickname, remap);
+                remapId(entry.feedType, remap);
+            }
+            animalTable.remapKeys(&remap[0]);
+        }
+
+        animals = std::move(loadedAnimals);
+        feedings = std::move(loadedFeedings);
+        return true;
+    }
+}
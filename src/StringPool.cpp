@@ -0,0 +1,115 @@
+#include "StringPool.h"
+#include "HashUtils.h"
+#include <cstring>
+
+StringPool::StringPool()
+    : blockUsed(0), blockCapacity(0), lookup(nullptr), lookupCapacity(0) {
+    intern("");
+}
+
+StringPool::~StringPool() {
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        delete[] blocks[i];
+    }
+    delete[] lookup;
+}
+
+StringPool& StringPool::global() {
+    static StringPool pool;
+    return pool;
+}
+
+const char* StringPool::store(std::string_view text) {
+    size_t needed = text.length() + 1;
+    if (blockUsed + needed > blockCapacity) {
+        // Длинные строки получают собственный блок, остальные делят общий
+        size_t capacity = needed > BLOCK_SIZE ? needed : BLOCK_SIZE;
+        blocks.push_back(new char[capacity]);
+        blockUsed = 0;
+        blockCapacity = capacity;
+    }
+    char* dest = blocks[blocks.size() - 1] + blockUsed;
+    if (!text.empty()) {
+        std::memcpy(dest, text.data(), text.length());
+    }
+    dest[text.length()] = '\0';
+    blockUsed += needed;
+    return dest;
+}
+
+void StringPool::growLookup() {
+    uint32_t newCapacity = lookupCapacity == 0 ? 64 : lookupCapacity * 2;
+    uint32_t* newLookup = new uint32_t[newCapacity];
+    for (uint32_t i = 0; i < newCapacity; ++i) {
+        newLookup[i] = NO_ID;
+    }
+
+    uint32_t mask = newCapacity - 1;
+    for (uint32_t id = 0; id < lengths.size(); ++id) {
+        uint32_t slot = static_cast<uint32_t>(hashes[id]) & mask;
+        while (newLookup[slot] != NO_ID) {
+            slot = (slot + 1) & mask;
+        }
+        newLookup[slot] = id;
+    }
+
+    delete[] lookup;
+    lookup = newLookup;
+    lookupCapacity = newCapacity;
+}
+
+uint32_t StringPool::find(std::string_view text) const {
+    if (lookupCapacity == 0) {
+        return NO_ID;
+    }
+    uint64_t hash = HashUtils::hashBytes(text, HashUtils::DEFAULT_SEED);
+    uint32_t mask = lookupCapacity - 1;
+    uint32_t slot = static_cast<uint32_t>(hash) & mask;
+
+    while (lookup[slot] != NO_ID) {
+        uint32_t id = lookup[slot];
+        if (hashes[id] == hash && view(id) == text) {
+            return id;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NO_ID;
+}
+
+uint32_t StringPool::intern(std::string_view text) {
+    // Таблица поиска заполняется не больше чем наполовину
+    if ((lengths.size() + 1) * 2 > lookupCapacity) {
+        growLookup();
+    }
+
+    uint64_t hash = HashUtils::hashBytes(text, HashUtils::DEFAULT_SEED);
+    uint32_t mask = lookupCapacity - 1;
+    uint32_t slot = static_cast<uint32_t>(hash) & mask;
+
+    while (lookup[slot] != NO_ID) {
+        uint32_t id = lookup[slot];
+        if (hashes[id] == hash && view(id) == text) {
+            return id;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    uint32_t id = static_cast<uint32_t>(lengths.size());
+    texts.push_back(store(text));
+    lengths.push_back(static_cast<uint32_t>(text.length()));
+    hashes.push_back(hash);
+    lookup[slot] = id;
+    return id;
+}
+
+std::ostream& operator<<(std::ostream& out, InternedString s) {
+    return out << s.view();
+}
+
+std::istream& operator>>(std::istream& in, InternedString& s) {
+    std::string text;
+    if (in >> text) {
+        s = InternedString(text);
+    }
+    return in;
+}
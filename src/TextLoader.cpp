@@ -0,0 +1,102 @@
+#include "TextLoader.h"
+#include <charconv>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TEXT_LOADER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace TextLoader {
+    const char* findNewline(const char* begin, const char* end) {
+#ifdef TEXT_LOADER_SSE2
+        const __m128i newline = _mm_set1_epi8('\n');
+        while (end - begin >= 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+            if (mask) {
+#ifdef _MSC_VER
+                unsigned long bit;
+                _BitScanForward(&bit, mask);
+                return begin + bit;
+#else
+                return begin + __builtin_ctz(mask);
+#endif
+            }
+            begin += 16;
+        }
+#endif
+        const void* found = begin < end ? std::memchr(begin, '\n', static_cast<size_t>(end - begin)) : nullptr;
+        return found ? static_cast<const char*>(found) : end;
+    }
+
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f' || c == '\n';
+    }
+
+    int splitFields(std::string_view line, std::string_view* fields, int maxFields) {
+        const char* cur = line.data();
+        const char* end = cur + line.size();
+        int count = 0;
+
+        while (count < maxFields) {
+            while (cur < end && isSpace(*cur)) ++cur;
+            if (cur == end) break;
+            const char* start = cur;
+            while (cur < end && !isSpace(*cur)) ++cur;
+            fields[count++] = std::string_view(start, static_cast<size_t>(cur - start));
+        }
+        return count;
+    }
+
+    int splitChunks(const char* begin, const char* end, int maxParts, size_t minPartSize,
+                    DynamicArray<const char*>& bounds) {
+        size_t total = static_cast<size_t>(end - begin);
+        size_t parts = maxParts > 1 ? static_cast<size_t>(maxParts) : 1;
+        if (minPartSize > 0 && total / minPartSize < parts) {
+            parts = total / minPartSize > 0 ? total / minPartSize : 1;
+        }
+
+        bounds.clear();
+        bounds.push_back(begin);
+        for (size_t i = 1; i < parts; ++i) {
+            const char* target = begin + total / parts * i;
+            if (target <= bounds[bounds.size() - 1]) continue;
+            // Граница сдвигается на начало следующей строки
+            const char* next = findNewline(target - 1, end);
+            if (next == end) break;
+            bounds.push_back(next + 1);
+        }
+        if (bounds[bounds.size() - 1] != end || bounds.size() == 1) {
+            bounds.push_back(end);
+        }
+        return static_cast<int>(bounds.size()) - 1;
+    }
+
+    int workerCount(int threadCount) {
+        if (threadCount > 0) {
+            return threadCount;
+        }
+        unsigned cores = std::thread::hardware_concurrency();
+        return cores > 0 ? static_cast<int>(cores) : 1;
+    }
+
+    bool parseInt(std::string_view field, int& value) {
+        const char* begin = field.data();
+        const char* end = begin + field.size();
+        // from_chars не принимает '+', а operator>> принимает
+        if (begin < end && *begin == '+') {
+            ++begin;
+            if (begin < end && *begin == '-') return false;
+        }
+        if (begin == end) {
+            return false;
+        }
+        auto result = std::from_chars(begin, end, value);
+        return result.ec == std::errc() && result.ptr == end;
+    }
+}
@@ -0,0 +1,246 @@
+#include "ZooCatalog.h"
+#include "Snapshot.h"
+#include "TextLoader.h"
+#include <algorithm>
+
+namespace {
+
+// Порядок (key, index), который ожидает buildFromSorted
+template <typename Entry>
+void sortByKeyAndIndex(DynamicArray<Entry>& entries) {
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.key < b.key) return true;
+        if (b.key < a.key) return false;
+        return a.index < b.index;
+    });
+}
+
+}
+
+ZooCatalog::ZooCatalog()
+    : animalTable(16),
+      feedingTree(&feedingIndexArena),
+      quantityTree(&feedingIndexArena),
+      dateTree(&feedingIndexArena),
+      speciesTree(&animalIndexArena) {}
+
+int ZooCatalog::findAnimal(std::string_view nickname) const {
+    int steps;
+    return animalTable.search(nickname, steps);
+}
+
+int ZooCatalog::findAnimalInterned(InternedString nickname) const {
+    int steps;
+    return animalTable.searchInterned(nickname, steps);
+}
+
+int ZooCatalog::findFeeding(const FeedingEntry& entry) const {
+    // Строки, не найденные через InternedString::lookup, ни в одной записи не встречаются
+    if (!entry.nickname.isValid() || !entry.feedType.isValid()) {
+        return -1;
+    }
+    // Кандидаты - только кормления этого животного
+    PostingsView<CircularList> candidates = feedingTree.search(entry.nickname.view());
+    for (int id : candidates) {
+        const FeedingEntry& f = feedings.get(id);
+        if (f.feedType == entry.feedType && f.quantity == entry.quantity && f.date == entry.date) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+int ZooCatalog::addAnimal(const Animal& animal) {
+    if (findAnimalInterned(animal.nickname) >= 0) {
+        return -1;
+    }
+    int id = animals.insert(animal);
+    animalTable.insert(animal.nickname, id);
+    speciesTree.add(animal.species, id);
+    return id;
+}
+
+int ZooCatalog::removeAnimal(int id) {
+    if (!animals.contains(id)) {
+        return 0;
+    }
+    Animal removed = animals.get(id);
+
+    // Список копируется: удаление кормлений меняет узел дерева
+    CircularList victims = feedingTree.search(removed.nickname.view()).toList();
+    for (int feedingId : victims) {
+        removeFeeding(feedingId);
+    }
+
+    animalTable.removeInterned(removed.nickname);
+    speciesTree.remove(removed.species, id);
+    animals.erase(id);
+    return victims.size();
+}
+
+int ZooCatalog::addFeeding(const FeedingEntry& entry) {
+    if (findAnimalInterned(entry.nickname) < 0) {
+        return -1;
+    }
+    int id = feedings.insert(entry);
+    indexFeeding(id);
+    return id;
+}
+
+void ZooCatalog::removeFeeding(int id) {
+    if (!feedings.contains(id)) {
+        return;
+    }
+    unindexFeeding(id);
+    feedings.erase(id);
+}
+
+void ZooCatalog::indexFeeding(int id) {
+    const FeedingEntry& f = feedings.get(id);
+    feedingTree.add(f.nickname, id);
+    quantityTree.add(f.quantity, id);
+    // Вес в дереве дат - количество: суммы за период берутся из агрегатов
+    dateTree.add(f.date, id, f.quantity);
+}
+
+void ZooCatalog::unindexFeeding(int id) {
+    const FeedingEntry& f = feedings.get(id);
+    feedingTree.remove(f.nickname, id);
+    quantityTree.remove(f.quantity, id);
+    dateTree.remove(f.date, id, f.quantity);
+}
+
+bool ZooCatalog::importAnimals(const std::string& filename, int& loaded, int& skipped) {
+    loaded = 0;
+    skipped = 0;
+    DynamicArray<Animal> parsed;
+    bool opened = TextLoader::forEachLine(filename, [&](std::string_view line) {
+        std::string_view fields[3];
+        if (TextLoader::splitFields(line, fields, 3) == 3) {
+            parsed.push_back(Animal(fields[0], fields[1], fields[2]));
+        }
+        return true;
+    });
+
+    // Повтор клички внутри файла отсеивается по отметкам, проиндексированным
+    // id строки пула (id плотные), а таблица заполняется один раз через build
+    DynamicArray<bool> taken;
+    taken.reserve(StringPool::global().size());
+    for (size_t id = 0; id < StringPool::global().size(); ++id) {
+        taken.push_back(false);
+    }
+    animals.reserve(animals.size() + parsed.size());
+    for (size_t i = 0; i < parsed.size(); ++i) {
+        const Animal& animal = parsed[i];
+        if (taken[animal.nickname.getId()] || findAnimalInterned(animal.nickname) >= 0) {
+            skipped++;
+            continue;
+        }
+        taken[animal.nickname.getId()] = true;
+        animals.insert(animal);
+        loaded++;
+    }
+    if (loaded > 0) {
+        // Кормления не менялись: их деревья остаются как есть
+        animalTable.build(animals);
+        rebuildSpeciesIndex();
+    }
+    return opened;
+}
+
+bool ZooCatalog::importFeedings(const std::string& filename, int& loaded, int& skipped) {
+    DynamicArray<FeedingEntry> parsed;
+    skipped = 0;
+    bool opened = feedingTree.importFromFileParallel(filename, parsed, &animalTable, &skipped);
+    loaded = static_cast<int>(parsed.size());
+    if (opened) {
+        feedings.reserve(feedings.size() + parsed.size());
+        for (size_t i = 0; i < parsed.size(); ++i) {
+            feedings.insert(parsed[i]);
+        }
+        rebuildFeedingIndexes();
+    }
+    return opened;
+}
+
+bool ZooCatalog::saveSnapshot(const std::string& filename) {
+    return Snapshot::save(filename, animals, feedings, animalTable);
+}
+
+bool ZooCatalog::loadSnapshot(const std::string& filename) {
+    if (!Snapshot::load(filename, animals, feedings, animalTable)) {
+        return false;
+    }
+    rebuildIndexTrees();
+    return true;
+}
+
+void ZooCatalog::resizeAnimalTable(int initialSize) {
+    animalTable.resize(initialSize);
+    animalTable.build(animals);
+}
+
+void ZooCatalog::clear() {
+    animals.clear();
+    feedings.clear();
+    rebuild();
+}
+
+void ZooCatalog::clearFeedings() {
+    feedings.clear();
+    clearFeedingIndexes();
+}
+
+void ZooCatalog::clearFeedingIndexes() {
+    feedingTree.clear();
+    quantityTree.clear();
+    dateTree.clear();
+    feedingIndexArena.reset();
+}
+
+void ZooCatalog::rebuild() {
+    animalTable.build(animals);
+    rebuildIndexTrees();
+}
+
+// Записи сортируются один раз, деревья строятся снизу вверх за O(n)
+// вместо вставки по одной с поворотами
+void ZooCatalog::rebuildIndexTrees() {
+    rebuildSpeciesIndex();
+    rebuildFeedingIndexes();
+}
+
+void ZooCatalog::rebuildSpeciesIndex() {
+    speciesTree.clear();
+    animalIndexArena.reset();
+    DynamicArray<SpeciesFiltersTree::BuildEntry> bySpecies;
+    bySpecies.reserve(animals.size());
+    for (size_t i = 0; i < animals.size(); ++i) {
+        bySpecies.push_back(SpeciesFiltersTree::BuildEntry{animals.valueAt(i).species, animals.idAt(i), 0});
+    }
+    sortByKeyAndIndex(bySpecies);
+    speciesTree.buildFromSorted(bySpecies.data(), bySpecies.size());
+}
+
+void ZooCatalog::rebuildFeedingIndexes() {
+    clearFeedingIndexes();
+    DynamicArray<FeedingTree::BuildEntry> byNickname;
+    DynamicArray<QuantityFiltersTree::BuildEntry> byQuantity;
+    DynamicArray<DateFiltersTree::BuildEntry> byDate;
+    byNickname.reserve(feedings.size());
+    byQuantity.reserve(feedings.size());
+    byDate.reserve(feedings.size());
+    for (size_t i = 0; i < feedings.size(); ++i) {
+        const FeedingEntry& f = feedings.valueAt(i);
+        int id = feedings.idAt(i);
+        byNickname.push_back(FeedingTree::BuildEntry{f.nickname, id});
+        byQuantity.push_back(QuantityFiltersTree::BuildEntry{f.quantity, id, 0});
+        byDate.push_back(DateFiltersTree::BuildEntry{f.date, id, f.quantity});
+    }
+    sortByKeyAndIndex(byNickname);
+    sortByKeyAndIndex(byQuantity);
+    sortByKeyAndIndex(byDate);
+    feedingTree.buildFromSorted(byNickname.data(), byNickname.size());
+    quantityTree.buildFromSorted(byQuantity.data(), byQuantity.size());
+    dateTree.buildFromSorted(byDate.data(), byDate.size());
+}